@@ -19,6 +19,8 @@
 #include "Entity.h"
 #include <atomic>
 #include <cstdint>
+#include <limits>
+#include <cassert>
 #include "../log/log.h"
 
 /**
@@ -33,40 +35,74 @@
  *      ctor for entity
  */
 Entity::Entity(const int32_t nid, const SDL_Rect& dest):id(nid), destRect(dest), srcRect({0,0, dest.w, dest.h}),
-        movementHitBox(dest), projectileHitBox(dest), damageHitBox(dest), pickupHitBox(dest),
-        x(dest.x), y(dest.y) {
+        movementBox(extent(dest, dest)), projectileBox(extent(dest, dest)), damageBox(extent(dest, dest)),
+        pickupBox(extent(dest, dest)), x(dest.x), y(dest.y) {
 }
 
 Entity::Entity(const int32_t nid, const SDL_Rect& dest, const SDL_Rect& movementSize): id(nid), destRect(dest),
-        srcRect({0,0, dest.w, dest.h}), movementHitBox(movementSize), projectileHitBox(dest),
-        damageHitBox(dest), pickupHitBox(dest), x(dest.x), y(dest.y) {
+        srcRect({0,0, dest.w, dest.h}), movementBox(extent(movementSize, dest)), projectileBox(extent(dest, dest)),
+        damageBox(extent(dest, dest)), pickupBox(extent(dest, dest)), x(dest.x), y(dest.y) {
 }
 
 //Weapon drops
 Entity::Entity(const int32_t nid, const SDL_Rect& dest, const SDL_Rect& movementSize,
         const SDL_Rect &pickupSize): id(nid), destRect(dest), srcRect({0,0, dest.w, dest.h}),
-        movementHitBox(movementSize), projectileHitBox(dest), damageHitBox(dest),pickupHitBox(pickupSize),
-        x(dest.x), y(dest.y) {
+        movementBox(extent(movementSize, dest)), projectileBox(extent(dest, dest)), damageBox(extent(dest, dest)),
+        pickupBox(extent(pickupSize, dest)), x(dest.x), y(dest.y) {
 }
 
 Entity::Entity(const int32_t nid, const SDL_Rect& dest, const SDL_Rect& movementSize,
         const SDL_Rect& projectileSize, const SDL_Rect& damageSize): id(nid), destRect(dest),
-        srcRect({0,0, dest.w, dest.h}), movementHitBox(movementSize), projectileHitBox(projectileSize),
-        damageHitBox(damageSize), pickupHitBox(dest), x(dest.x), y(dest.y) {
+        srcRect({0,0, dest.w, dest.h}), movementBox(extent(movementSize, dest)),
+        projectileBox(extent(projectileSize, dest)), damageBox(extent(damageSize, dest)),
+        pickupBox(extent(dest, dest)), x(dest.x), y(dest.y) {
 }
 
 
 //movables and marines
 Entity::Entity(const int32_t nid, const SDL_Rect& dest, const SDL_Rect& movementSize,
         const SDL_Rect& projectileSize, const SDL_Rect& damageSize, const SDL_Rect& pickupSize):
-        id(nid), destRect(dest), srcRect({0,0, dest.w, dest.h}), movementHitBox(movementSize),
-        projectileHitBox(projectileSize), damageHitBox(damageSize), pickupHitBox(pickupSize),
-        x(dest.x), y(dest.y) {
+        id(nid), destRect(dest), srcRect({0,0, dest.w, dest.h}), movementBox(extent(movementSize, dest)),
+        projectileBox(extent(projectileSize, dest)), damageBox(extent(damageSize, dest)),
+        pickupBox(extent(pickupSize, dest)), x(dest.x), y(dest.y) {
 }
 
 Entity::Entity(const Entity& e): id(e.id), destRect(e.destRect), srcRect(e.srcRect),
-        movementHitBox(e.movementHitBox), projectileHitBox(e.projectileHitBox),
-        damageHitBox(e.damageHitBox), pickupHitBox(e.pickupHitBox), x(e.x), y(e.y) {
+        movementBox(e.movementBox), projectileBox(e.projectileBox), damageBox(e.damageBox),
+        pickupBox(e.pickupBox), x(e.x), y(e.y), playerFriendly(e.playerFriendly), anchored(e.anchored) {
+}
+
+/**
+ * Function Interface: HitBoxExtent extent(const SDL_Rect& box, const SDL_Rect& origin)
+ *      box : Hitbox rect
+ *      origin : Rect of the entity the hitbox belongs to
+ *
+ * Description:
+ *      Returns where the hitbox sits relative to the top left corner of the entity, and its size.
+ */
+HitBoxExtent Entity::extent(const SDL_Rect& box, const SDL_Rect& origin) {
+    const int values[] = {box.x - origin.x, box.y - origin.y, box.w, box.h};
+    for (const int value : values) {
+        assert(value >= std::numeric_limits<int16_t>::min() && value <= std::numeric_limits<int16_t>::max());
+        (void) value;
+    }
+    return {static_cast<int16_t>(values[0]), static_cast<int16_t>(values[1]),
+        static_cast<int16_t>(values[2]), static_cast<int16_t>(values[3])};
+}
+
+/**
+ * Function Interface: void moveHitBox(HitBoxExtent& box, const int x, const int y)
+ *      box : Hitbox to move
+ *      x : x position
+ *      y : y position
+ *
+ * Description:
+ *      Moves one hitbox to a position, keeping it there relative to the entity. The next move of
+ *      the entity anchors it back to the position.
+ */
+void Entity::moveHitBox(HitBoxExtent& box, const int x, const int y) {
+    box = extent({x, y, box.w, box.h}, destRect);
+    anchored = false;
 }
 
 const SDL_Rect Entity::getRelativeDestRect(const SDL_Rect& view) const {
@@ -86,7 +122,9 @@ const SDL_Rect Entity::getRelativeDestRect(const SDL_Rect& view) const {
 void Entity::setX(const float px) {
     x = px;
     destRect.x = px;
-    updateHitBoxes();
+    if (!anchored) {
+        updateHitBoxes();
+    }
 }
 
 /**
@@ -102,7 +140,9 @@ void Entity::setX(const float px) {
 void Entity::setY(const float py) {
     y = py;
     destRect.y = py;
-    updateHitBoxes();
+    if (!anchored) {
+        updateHitBoxes();
+    }
 }
 
 /**
@@ -115,43 +155,43 @@ void Entity::setY(const float py) {
  *
  * Description:
  *      Set Entity by x and y amount
+ *      Hitboxes follow the position on their own once anchored, so they are only moved here until then.
  */
 void Entity::setPosition(float px, float py) {
     x = px;
     y = py;
     destRect.x = px;
     destRect.y = py;
-    updateHitBoxes();
+    if (!anchored) {
+        updateHitBoxes();
+    }
 }
 
 /**
  * Date: Feb. 9, 2017
- * Modified: ----
  * Author: Jacob McPhail
  * Function Interface: updateHitBoxes() 
  * Description:
- *     Updates the hit boxes
+ *     Anchors the hit boxes to the position, with the pickup hitbox 10 pixels up and to the left
  */
 void Entity::updateHitBoxes() {
-    movementHitBox.move(x, y);
-    projectileHitBox.move(x, y);
-    damageHitBox.move(x, y);
-    pickupHitBox.move(x - 10, y - 10);
+    movementBox.x = movementBox.y = 0;
+    projectileBox.x = projectileBox.y = 0;
+    damageBox.x = damageBox.y = 0;
+    pickupBox.x = pickupBox.y = -10;
+    anchored = true;
 }
 
 /**
  * Date: Feb. 9, 2017
- * Modified: ----
  * Author: Jacob McPhail
  * Function Interface: updateRectHitBoxes() 
  * Description:
  *     Updates the rectangle for the hitbox
  */
 void Entity::updateRectHitBoxes() {
-    movementHitBox.setRect(destRect);
-    projectileHitBox.setRect(destRect);
-    damageHitBox.setRect(destRect);
-    pickupHitBox.setRect(destRect);
+    movementBox = projectileBox = damageBox = pickupBox = extent(destRect, destRect);
+    anchored = false;
 }
 
 /**
@@ -14,6 +14,9 @@
 * Author:
 *
 * Notes:
+*       Each hitbox is kept as a HitBoxExtent relative to the top left of destRect, so moving an
+*       entity only writes its position. The hitbox getters build the rects from the position
+*       when they are called and return them by value.
 *
 ------------------------------------------------------------------------------*/
 #ifndef ENTITY_H
@@ -57,16 +60,17 @@ public:
     int getH() const{return destRect.h;} // Get height
     void setW(const int w) {destRect.w = w;} // Set width
     void setH(const int h) {destRect.h = h;} // Set height
-    void updateHitBoxes(); // update hitbox positions
+    void updateHitBoxes(); // anchor hitboxes to the position
     void updateRectHitBoxes(); // update hitbox sizes
 
     int32_t getId()const{return id;}; //returns the id of the entity
 
-
-    const HitBox& getMoveHitBox()const {return movementHitBox;};
-    const HitBox& getProHitBox()const {return projectileHitBox;};
-    const HitBox& getDamHitBox()const {return damageHitBox;};
-    const HitBox& getPickUpHitBox()const {return pickupHitBox;};
+    // Hitboxes are built from the position on every call, keep a copy instead of a reference to the rect
+    HitBox getMoveHitBox()const {return place(movementBox);};
+    HitBox getProHitBox()const {return place(projectileBox);};
+    HitBox getDamHitBox()const {return place(damageBox);};
+    HitBox getPickUpHitBox()const {return place(pickupBox);};
+    void setPlayerFriendly(const bool isFriendly) {playerFriendly = isFriendly;}; // for every hitbox
 
     const SDL_Rect getRelativeDestRect(const SDL_Rect& view) const;
 
@@ -75,24 +79,35 @@ public:
     void setDestRect(const int x, const int y, const int width, const int height);
     void setSrcRect(const int x, const int y, const int width, const int height);
 
-    void moveMoveHitBox(const int x, const int y) { movementHitBox.move(x,y);};
-    void moveProHitBox(const int x, const int y) { projectileHitBox.move(x,y);};
-    void moveDamHitBox(const int x, const int y) { damageHitBox.move(x,y);};
-    void movePickUpHitBox(const int x, const int y) { pickupHitBox.move(x,y);};
+    void moveMoveHitBox(const int x, const int y) {moveHitBox(movementBox, x, y);};
+    void moveProHitBox(const int x, const int y) {moveHitBox(projectileBox, x, y);};
+    void moveDamHitBox(const int x, const int y) {moveHitBox(damageBox, x, y);};
+    void movePickUpHitBox(const int x, const int y) {moveHitBox(pickupBox, x, y);};
 
-    const std::pair<float, float> getMoveCoord() const {return {movementHitBox.getRect().x, movementHitBox.getRect().y};};
+    const std::pair<float, float> getMoveCoord() const {
+        return {destRect.x + movementBox.x, destRect.y + movementBox.y};
+    };
     const std::pair<float, float> getDestCoord() const {return {destRect.x, destRect.y};};
     const std::pair<float, float> getSrcCoord() const {return {srcRect.x, srcRect.y};};
 private:
+    static HitBoxExtent extent(const SDL_Rect& box, const SDL_Rect& origin);
+    HitBox place(const HitBoxExtent& box) const {
+        return HitBox({destRect.x + box.x, destRect.y + box.y, box.w, box.h}, playerFriendly);
+    }
+    void moveHitBox(HitBoxExtent& box, const int x, const int y);
+
     int32_t id; //is the index num of the entity in its respective manager
     SDL_Rect destRect;
     SDL_Rect srcRect;
-    HitBox movementHitBox;
-    HitBox projectileHitBox;
-    HitBox damageHitBox;
-    HitBox pickupHitBox;
+    HitBoxExtent movementBox;
+    HitBoxExtent projectileBox;
+    HitBoxExtent damageBox;
+    HitBoxExtent pickupBox;
     float x;
     float y;
+    bool playerFriendly = false;
+    //whether the hitboxes have been anchored to the position since they were last resized
+    bool anchored = false;
 };
 
 #endif
@@ -27,24 +27,10 @@
  * Author: Jacob McPhail
  * Function Interface: void Movable::move(float moveX, float moveY, CollisionHandler& ch)
  * Description:
- * move the movable object by moveX, moveY. If there is a collision detection, move it back
+ * move the movable object by moveX, moveY. The move is swept, so it stops against anything with a
+ * movement hitbox and slides along it
  */
 void Movable::move(const float moveX, const float moveY, CollisionHandler& ch){
-    //Move the Movable left or right
-    setX(getX() + moveX);
-
-    //if there is a collision with anything with a movement hitbox, move it back
-    if (ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieMovementTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieTree(),this),this)) {
-        setX(getX() - moveX);
-    }
-
-    //Move the Movable up or down
-    setY(getY()+moveY);
-
-    //if there is a collision with anything with a movement hitbox, move it back
-    if (ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieMovementTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieTree(),this),this)) {
-        setY(getY() - moveY);
-    }
+    const auto pos = ch.sweepMovement(this, moveX, moveY, CollisionCategory::MARINE_BLOCKERS);
+    setPosition(pos.first, pos.second);
 }
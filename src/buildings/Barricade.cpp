@@ -70,12 +70,7 @@ Barricade::~Barricade() {
 bool Barricade::checkPlaceablePosition(const float distance, CollisionHandler& ch) {
     placeable = (distance <= 200);
 
-    if(placeable && (ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getMarineTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getBarricadeTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getWallTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getTurretTree(),this),this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getObjTree(),this),this))) {
+    if(placeable && ch.detectMovementCollision(CollisionCategory::BARRICADE_BLOCKERS, this)) {
         placeable = false;
     }
     return placeable;
@@ -147,12 +142,15 @@ void Barricade::onCollision() {
  * Programmer: Terry Kang
  * Function Interface: void collidingProjectile(const int damage)
  * Description:
- * Called when collision with projectile occurs
+ * Called when collision with projectile occurs. The hit that breaks the barricade queues its deletion
+ * for the end of the tick.
  */
 void Barricade::collidingProjectile(const int damage) {
-    health -= damage;
-    if(health <= 0){
-        GameManager::instance()->deleteBarricade(getId());
+    int left;
+#pragma omp atomic capture
+    left = health -= damage;
+    if (left <= 0 && left + damage > 0) {
+        GameManager::instance()->queueDeletion(UDPHeaders::BARRICADE, getId());
     }
 }
 
@@ -168,4 +166,5 @@ void Barricade::collidingProjectile(const int damage) {
 void Barricade::placeBarricade() {
     // texture.setAlpha(255);
     placed = true;
+    GameManager::instance()->queuePathChange(getId());
 }
@@ -63,77 +63,41 @@ int WeaponStore::purchase(const int num, const int credits){
  * Creates weapon
  */
 int32_t WeaponStore::createWeapon(const int num, const int credits){
+    //weapons on sale, in the order of the store menu
+    static constexpr WeaponKind STOCK[] = {WeaponKind::RIFLE, WeaponKind::SHOTGUN, WeaponKind::PLASMA_DEAGLE,
+        WeaponKind::RAILGUN, WeaponKind::TYPE75, WeaponKind::KATANA, WeaponKind::PHASE_REPEATER};
+
+    if(num < 0 || num >= static_cast<int>(sizeof(STOCK) / sizeof(STOCK[0]))
+            || credits < getArchetype(STOCK[num]).price){
+        return -1;//does not exist or can't afford it
+    }
+
     GameManager *gm = GameManager::instance();
-    int32_t id = gm->generateID();
-    switch(num){
-        case 0:
-        {
-            Rifle r(id);
-            if(credits >= r.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<Rifle>(r)));
-                return id;
-            }
+    const int32_t id = gm->generateID();
+    switch(STOCK[num]){
+        case WeaponKind::RIFLE:
+            gm->addWeapon(std::make_shared<Rifle>(id));
             break;
-        }
-        case 1:
-        {
-            ShotGun s(id);
-            if(credits >= s.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<ShotGun>(s)));
-                return id;
-            }
+        case WeaponKind::SHOTGUN:
+            gm->addWeapon(std::make_shared<ShotGun>(id));
             break;
-        }
-        case 2:
-        {
-            PlasmaDeagle pd(id);
-            if(credits >= pd.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<PlasmaDeagle>(pd)));
-                return id;
-            }
+        case WeaponKind::PLASMA_DEAGLE:
+            gm->addWeapon(std::make_shared<PlasmaDeagle>(id));
             break;
-        }
-        case 3:
-        {
-            RailGun ra(id);
-            if(credits >= ra.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<RailGun>(ra)));
-                return id;
-            }
+        case WeaponKind::RAILGUN:
+            gm->addWeapon(std::make_shared<RailGun>(id));
             break;
-        }
-        case 4:
-        {
-            Type75 t7(id);
-            if(credits >= t7.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<Type75>(t7)));
-                return id;
-            }
+        case WeaponKind::TYPE75:
+            gm->addWeapon(std::make_shared<Type75>(id));
             break;
-        }
-        case 5:
-        {
-            Katana k(id);
-            if(credits >= k.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<Katana>(k)));
-                return id;
-            }
+        case WeaponKind::KATANA:
+            gm->addWeapon(std::make_shared<Katana>(id));
             break;
-        }
-        case 6:
-        {
-            PhaseRepeater pr(id);
-            if(credits >= pr.getPrice()){
-                gm->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<PhaseRepeater>(pr)));
-                return id;
-            }
+        case WeaponKind::PHASE_REPEATER:
+            gm->addWeapon(std::make_shared<PhaseRepeater>(id));
             break;
-        }
-        case 7:
-
         default:
-            return -1;//does not exist
+            return -1;
     }
-
-    return -1;
+    return id;
 }
@@ -0,0 +1,214 @@
+/*------------------------------------------------------------------------------
+* Header: BoxSet.cpp
+*
+* Functions:
+*       void push(Entity *entity, const unsigned int bits)
+*       void set(const unsigned int index)
+*       Entity *swapPop(const unsigned int index)
+*       void clear()
+*       unsigned int overlapBlock(const unsigned int first, const int32_t query[6]) const
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*
+------------------------------------------------------------------------------*/
+#include <SDL2/SDL.h>
+#include <limits>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "BoxSet.h"
+
+/**
+ * Function Interface: void push(Entity *entity, const unsigned int bits)
+ *      entity : Entity to add
+ *      bits : CollisionCategory bits of the entry
+ *
+ * Description:
+ *      Adds an entity and a copy of its movement hitbox to the end of the set,
+ *      growing the arrays by a full block when needed.
+ */
+void BoxSet::push(Entity *entity, const unsigned int bits) {
+    const unsigned int index = entities.size();
+    if (index % BOX_LANES == 0) {
+        //new lanes start as boxes that overlap nothing
+        left.resize(index + BOX_LANES, std::numeric_limits<int32_t>::max());
+        top.resize(index + BOX_LANES, std::numeric_limits<int32_t>::max());
+        right.resize(index + BOX_LANES, std::numeric_limits<int32_t>::min());
+        bottom.resize(index + BOX_LANES, std::numeric_limits<int32_t>::min());
+        friendly.resize(index + BOX_LANES, 0);
+        category.resize(index + BOX_LANES, 0);
+    }
+    entities.push_back(entity);
+    category[index] = bits;
+    set(index);
+}
+
+/**
+ * Function Interface: void set(const unsigned int index)
+ *      index : Slot to refresh
+ *
+ * Description:
+ *      Copies the current movement hitbox of the entity in a slot.
+ */
+void BoxSet::set(const unsigned int index) {
+    setBox(index, entities[index]->getMoveHitBox());
+}
+
+/**
+ * Function Interface: void setBox(const unsigned int index, const HitBox& box)
+ *      index : Slot to write
+ *      box : Hitbox to store
+ *
+ * Description:
+ *      Writes a hitbox into a slot. Empty boxes are stored so they overlap nothing,
+ *      the same as SDL_HasIntersection treats them.
+ */
+void BoxSet::setBox(const unsigned int index, const HitBox& box) {
+    const SDL_Rect& r = box.getRect();
+    if (r.w <= 0 || r.h <= 0) {
+        left[index] = std::numeric_limits<int32_t>::max();
+        top[index] = std::numeric_limits<int32_t>::max();
+        right[index] = std::numeric_limits<int32_t>::min();
+        bottom[index] = std::numeric_limits<int32_t>::min();
+    } else {
+        left[index] = r.x;
+        top[index] = r.y;
+        right[index] = r.x + r.w;
+        bottom[index] = r.y + r.h;
+    }
+    friendly[index] = box.isPlayerFriendly() ? -1 : 0;
+}
+
+/**
+ * Function Interface: Entity *swapPop(const unsigned int index)
+ *      index : Slot to empty
+ *
+ * Description:
+ *      Moves the last entity into the freed slot and shrinks the set. Returns the entity
+ *      that now holds the slot, or nullptr if the last slot was removed.
+ */
+Entity *BoxSet::swapPop(const unsigned int index) {
+    const unsigned int last = entities.size() - 1;
+    Entity *moved = nullptr;
+    if (index != last) {
+        moved = entities[index] = entities[last];
+        left[index] = left[last];
+        top[index] = top[last];
+        right[index] = right[last];
+        bottom[index] = bottom[last];
+        friendly[index] = friendly[last];
+        category[index] = category[last];
+    }
+    entities.pop_back();
+
+    if (last % BOX_LANES == 0) {
+        left.resize(last);
+        top.resize(last);
+        right.resize(last);
+        bottom.resize(last);
+        friendly.resize(last);
+        category.resize(last);
+    } else {
+        left[last] = std::numeric_limits<int32_t>::max();
+        top[last] = std::numeric_limits<int32_t>::max();
+        right[last] = std::numeric_limits<int32_t>::min();
+        bottom[last] = std::numeric_limits<int32_t>::min();
+        friendly[last] = 0;
+        category[last] = 0;
+    }
+    return moved;
+}
+
+/**
+ * Function Interface: void clear()
+ *
+ * Description:
+ *      Removes everything from the set, keeping its storage.
+ */
+void BoxSet::clear() {
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+    friendly.clear();
+    category.clear();
+    entities.clear();
+}
+
+/**
+ * Function Interface: unsigned int overlapBlock(const unsigned int first, const int32_t query[6]) const
+ *      first : First slot of the block, a multiple of BOX_LANES
+ *      query : Left, top, right and bottom of the tested box, its friendly mask, then the categories searched
+ *
+ * Description:
+ *      Tests a block of BOX_LANES boxes against the query. Returns a mask with a bit set for
+ *      every box in the searched categories that overlaps it and is not friendly to it.
+ */
+unsigned int BoxSet::overlapBlock(const unsigned int first, const int32_t query[6]) const {
+#if defined(__AVX2__)
+    const __m256i qLeft = _mm256_set1_epi32(query[0]);
+    const __m256i qTop = _mm256_set1_epi32(query[1]);
+    const __m256i qRight = _mm256_set1_epi32(query[2]);
+    const __m256i qBottom = _mm256_set1_epi32(query[3]);
+    const __m256i qFriendly = _mm256_set1_epi32(query[4]);
+    const __m256i qCategory = _mm256_set1_epi32(query[5]);
+
+    const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&left[first]));
+    const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&top[first]));
+    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&right[first]));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&bottom[first]));
+    const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&friendly[first]));
+    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&category[first]));
+
+    __m256i hit = _mm256_and_si256(_mm256_cmpgt_epi32(qRight, l), _mm256_cmpgt_epi32(r, qLeft));
+    hit = _mm256_and_si256(hit, _mm256_cmpgt_epi32(qBottom, t));
+    hit = _mm256_and_si256(hit, _mm256_cmpgt_epi32(b, qTop));
+    hit = _mm256_andnot_si256(_mm256_and_si256(f, qFriendly), hit);
+    hit = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_and_si256(c, qCategory), _mm256_setzero_si256()), hit);
+    return _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+#elif defined(__SSE2__)
+    const __m128i qLeft = _mm_set1_epi32(query[0]);
+    const __m128i qTop = _mm_set1_epi32(query[1]);
+    const __m128i qRight = _mm_set1_epi32(query[2]);
+    const __m128i qBottom = _mm_set1_epi32(query[3]);
+    const __m128i qFriendly = _mm_set1_epi32(query[4]);
+    const __m128i qCategory = _mm_set1_epi32(query[5]);
+
+    unsigned int mask = 0;
+    for (unsigned int half = 0; half < BOX_LANES; half += 4) {
+        const unsigned int i = first + half;
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&left[i]));
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&top[i]));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&right[i]));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bottom[i]));
+        const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&friendly[i]));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&category[i]));
+
+        __m128i hit = _mm_and_si128(_mm_cmpgt_epi32(qRight, l), _mm_cmpgt_epi32(r, qLeft));
+        hit = _mm_and_si128(hit, _mm_cmpgt_epi32(qBottom, t));
+        hit = _mm_and_si128(hit, _mm_cmpgt_epi32(b, qTop));
+        hit = _mm_andnot_si128(_mm_and_si128(f, qFriendly), hit);
+        hit = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(c, qCategory), _mm_setzero_si128()), hit);
+        mask |= _mm_movemask_ps(_mm_castsi128_ps(hit)) << half;
+    }
+    return mask;
+#else
+    unsigned int mask = 0;
+    for (unsigned int lane = 0; lane < BOX_LANES; ++lane) {
+        const unsigned int i = first + lane;
+        if (query[2] > left[i] && right[i] > query[0] && query[3] > top[i] && bottom[i] > query[1]
+                && !(friendly[i] & query[4]) && (category[i] & static_cast<uint32_t>(query[5]))) {
+            mask |= 1u << lane;
+        }
+    }
+    return mask;
+#endif
+}
@@ -0,0 +1,130 @@
+/*------------------------------------------------------------------------------
+* Header: BoxSet.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Entities together with a copy of their movement hitbox, kept as separate arrays of
+*       left, top, right and bottom edges, a friendly mask and the category bits of
+*       the entry. The arrays are padded to a
+*       multiple of BOX_LANES with boxes that can never overlap anything, so a whole block
+*       of boxes can be tested against a rect at once.
+*       The block test uses AVX2 or SSE2 when the compiler is allowed to, otherwise plain C++.
+*       The copies are only as fresh as the last call to set().
+*
+------------------------------------------------------------------------------*/
+#ifndef BOXSET_H
+#define BOXSET_H
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+
+#include "../basic/Entity.h"
+
+//number of boxes tested together
+static constexpr unsigned int BOX_LANES = 8;
+
+class BoxSet {
+public:
+    BoxSet() = default;
+    ~BoxSet() = default;
+
+    unsigned int size() const {return entities.size();}
+    bool empty() const {return entities.empty();}
+    Entity *operator[](const unsigned int index) const {return entities[index];}
+    std::vector<Entity *>::const_iterator begin() const {return entities.begin();}
+    std::vector<Entity *>::const_iterator end() const {return entities.end();}
+
+    void push(Entity *entity, const unsigned int bits);
+    void set(const unsigned int index);
+    void setBox(const unsigned int index, const HitBox& box);
+    unsigned int getCategory(const unsigned int index) const {return category[index];}
+    void setCategory(const unsigned int index, const unsigned int bits) {category[index] = bits;}
+    Entity *swapPop(const unsigned int index);
+    void clear();
+
+    template<typename Visitor>
+    bool visit(const unsigned int mask, Visitor&& visitor) const;
+    template<typename Visitor>
+    bool visitOverlapping(const SDL_Rect& rect, const bool friendly, const unsigned int mask,
+        Visitor&& visitor) const;
+
+private:
+    unsigned int overlapBlock(const unsigned int first, const int32_t query[6]) const;
+
+    std::vector<int32_t> left;
+    std::vector<int32_t> top;
+    std::vector<int32_t> right;
+    std::vector<int32_t> bottom;
+    //all bits set for player friendly boxes
+    std::vector<int32_t> friendly;
+    //CollisionCategory bits of each entry
+    std::vector<uint32_t> category;
+    std::vector<Entity *> entities;
+};
+
+/**
+ * Function Interface: bool visit(const unsigned int mask, Visitor&& visitor) const
+ *      mask : Categories to visit
+ *      visitor : Called with every entity sharing a category with the mask,
+ *                returning true stops the search
+ *
+ * Description:
+ *      Visits the entries in the mask without looking at their boxes. Returns true if the
+ *      visitor stopped the search.
+ */
+template<typename Visitor>
+bool BoxSet::visit(const unsigned int mask, Visitor&& visitor) const {
+    for (unsigned int i = 0; i < entities.size(); ++i) {
+        if ((category[i] & mask) && visitor(entities[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visitOverlapping(const SDL_Rect& rect, const bool friendly, const unsigned int mask,
+ *          Visitor&& visitor) const
+ *      rect : Movement hitbox to test
+ *      friendly : Whether the tested hitbox is player friendly
+ *      mask : Categories to test against
+ *      visitor : Called with every entity in the mask whose stored box overlaps the rect and is not
+ *                friendly to it, returning true stops the search
+ *
+ * Description:
+ *      Tests the stored boxes a block at a time. Matches SDL_HasIntersection, so boxes that only
+ *      touch do not overlap. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool BoxSet::visitOverlapping(const SDL_Rect& rect, const bool friendly, const unsigned int mask,
+        Visitor&& visitor) const {
+    if (rect.w <= 0 || rect.h <= 0) {
+        return false;
+    }
+    const int32_t query[6] = {rect.x, rect.y, rect.x + rect.w, rect.y + rect.h, friendly ? -1 : 0,
+        static_cast<int32_t>(mask)};
+
+    for (unsigned int first = 0; first < entities.size(); first += BOX_LANES) {
+        unsigned int lanes = overlapBlock(first, query);
+        while (lanes) {
+            const unsigned int lane = __builtin_ctz(lanes);
+            lanes &= lanes - 1;
+            if (visitor(entities[first + lane])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+#endif
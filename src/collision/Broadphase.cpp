@@ -0,0 +1,214 @@
+/*------------------------------------------------------------------------------
+* Header: Broadphase.cpp
+*
+* Functions:
+*       void begin(const int pReach)
+*       void add(Entity *entity, const unsigned int category)
+*       void build(const unsigned int pApart)
+*       void clear()
+*       void addLate(Entity *entity, const unsigned int category)
+*       void remove(const Entity *entity)
+*       void reserve(const unsigned int n)
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*
+------------------------------------------------------------------------------*/
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include "Broadphase.h"
+
+/**
+ * Function Interface: void begin(const int pReach)
+ *      pReach : Furthest anything can move before the next build, in pixels
+ *
+ * Description:
+ *      Empties the pass so the units for the next build can be added.
+ */
+void Broadphase::begin(const int pReach) {
+    clear();
+    reach = std::max(pReach, 0);
+}
+
+/**
+ * Function Interface: void add(Entity *entity, const unsigned int category)
+ *      entity : Unit to add
+ *      category : CollisionCategory bits of the unit
+ *
+ * Description:
+ *      Copies the current movement hitbox of a unit into the pass. Units with an empty hitbox
+ *      never collide, so they are given an empty grown box and are never paired.
+ */
+void Broadphase::add(Entity *entity, const unsigned int category) {
+    const HitBox hitBox = entity->getMoveHitBox();
+    const SDL_Rect& box = hitBox.getRect();
+    SDL_Rect grown = {0, 0, 0, 0};
+    if (box.w > 0 && box.h > 0) {
+        grown = {box.x - reach, box.y - reach, box.w + 2 * reach, box.h + 2 * reach};
+    }
+    units.push_back({box, grown, entity, category, hitBox.isPlayerFriendly()});
+}
+
+/**
+ * Function Interface: void build(const unsigned int pApart)
+ *      pApart : Categories that are never checked against each other, like zombies which walk through
+ *              one another. Two units that both only hold these categories are not paired.
+ *
+ * Description:
+ *      Sorts the units by the left edge of their grown boxes, then sweeps along x keeping a list of the
+ *      units whose grown boxes are still open. Each unit is paired with every open unit it overlaps
+ *      in y, so the work is the sort plus the number of pairs. Player friendly units never block each
+ *      other and are not paired.
+ *      The pairs are then grouped by unit into one flat array.
+ */
+void Broadphase::build(const unsigned int pApart) {
+    apart = pApart;
+    std::sort(units.begin(), units.end(), [](const Unit& a, const Unit& b) {
+        return a.grown.x < b.grown.x;
+    });
+
+    active.clear();
+    found.clear();
+    for (unsigned int i = 0; i < units.size(); ++i) {
+        const Unit& unit = units[i];
+        if (unit.grown.w <= 0) {
+            continue;
+        }
+        //close every unit whose grown box ends before this one starts, boxes that only touch don't overlap
+        for (unsigned int a = 0; a < active.size();) {
+            const SDL_Rect& open = units[active[a]].grown;
+            if (open.x + open.w <= unit.grown.x) {
+                active[a] = active.back();
+                active.pop_back();
+            } else {
+                ++a;
+            }
+        }
+        for (const unsigned int j : active) {
+            const Unit& other = units[j];
+            if (other.grown.y < unit.grown.y + unit.grown.h && unit.grown.y < other.grown.y + other.grown.h
+                    && !(unit.friendly && other.friendly)
+                    && ((unit.category | other.category) & ~apart)) {
+                found.emplace_back(j, i);
+            }
+        }
+        active.push_back(i);
+    }
+
+    offsets.assign(units.size() + 1, 0);
+    for (const auto& pair : found) {
+        ++offsets[pair.first + 1];
+        ++offsets[pair.second + 1];
+    }
+    for (unsigned int i = 0; i < units.size(); ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    pairs.resize(found.size() * 2);
+    //active is reused as the next free spot in each unit's run
+    active.assign(offsets.begin(), offsets.end() - 1);
+    for (const auto& pair : found) {
+        pairs[active[pair.first]++] = pair.second;
+        pairs[active[pair.second]++] = pair.first;
+    }
+
+    indices.clear();
+    indices.reserve(units.size());
+    for (unsigned int i = 0; i < units.size(); ++i) {
+        indices.insert(units[i].entity, i);
+    }
+    paired = units.size();
+    valid = true;
+}
+
+/**
+ * Function Interface: void clear()
+ *
+ * Description:
+ *      Empties the pass, keeping its storage. Movement checks search the grid until the next build.
+ */
+void Broadphase::clear() {
+    units.clear();
+    offsets.clear();
+    pairs.clear();
+    indices.clear();
+    paired = 0;
+    valid = false;
+}
+
+/**
+ * Function Interface: void addLate(Entity *entity, const unsigned int category)
+ *      entity : Unit inserted or moved since the last build
+ *      category : CollisionCategory bits of the unit
+ *
+ * Description:
+ *      Keeps the unit after the paired ones with its current movement hitbox, so every run is checked
+ *      against it without rebuilding the pass. A unit that was already in a run is dropped from it first,
+ *      since its stored box is out of date. Units with an empty hitbox never collide and are kept with
+ *      no categories, only so their own checks still go back to the grid.
+ */
+void Broadphase::addLate(Entity *entity, const unsigned int category) {
+    if (!valid) {
+        return;
+    }
+    const HitBox hitBox = entity->getMoveHitBox();
+    const SDL_Rect& box = hitBox.getRect();
+    const unsigned int bits = (box.w > 0 && box.h > 0) ? category : CollisionCategory::NONE;
+    const unsigned int *const found = indices.get(entity);
+    if (found && *found >= paired) {
+        units[*found].box = box;
+        units[*found].category = bits;
+        return;
+    }
+    if (found) {
+        units[*found].category = CollisionCategory::NONE;
+    }
+    indices.insert(entity, units.size());
+    units.push_back({box, {0, 0, 0, 0}, entity, bits, hitBox.isPlayerFriendly()});
+}
+
+/**
+ * Function Interface: void remove(const Entity *entity)
+ *      entity : Unit that is leaving the game
+ *
+ * Description:
+ *      Clears the categories of a unit so it is skipped by every run it is in.
+ *      The unit keeps its place until the next build.
+ */
+void Broadphase::remove(const Entity *entity) {
+    if (const unsigned int *const found = indices.get(entity)) {
+        units[*found].category = CollisionCategory::NONE;
+    }
+}
+
+/**
+ * Function Interface: void reserve(const unsigned int n)
+ *      n : Most marines and zombies that will be in the pass at once, paired or added late
+ *
+ * Description:
+ *      Makes room for n units, so adding units between builds never allocates.
+ */
+void Broadphase::reserve(const unsigned int n) {
+    units.reserve(n);
+    offsets.reserve(n + 1);
+    indices.reserve(n);
+}
+
+/**
+ * Function Interface: bool contains(const SDL_Rect& outer, const SDL_Rect& inner)
+ *      outer : Box that has to hold the other
+ *      inner : Box to check
+ *
+ * Description:
+ *      Returns true if inner lies entirely inside outer.
+ */
+bool Broadphase::contains(const SDL_Rect& outer, const SDL_Rect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y
+        && inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
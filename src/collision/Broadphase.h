@@ -0,0 +1,137 @@
+/*------------------------------------------------------------------------------
+* Header: Broadphase.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Sort and sweep pass over every marine and zombie, run once a frame after the grid is refreshed.
+*       Each unit's movement hitbox is grown by how far anything can move in the frame, the grown boxes
+*       are sorted by their left edge and swept along x once, and every pair whose grown boxes
+*       overlap is written to one flat array. The pairs of each unit are kept together, with an offset
+*       per unit into the array, so a unit's candidates are a single contiguous run.
+*       A move that stays inside the unit's grown box can only touch units in its run, so movement checks
+*       read the run instead of searching the grid.
+*       Units added after build() are not in any run. They are kept after the paired units and checked
+*       alongside every run until the next build(), while their own checks go back to the grid.
+*       Units removed are only marked, their pairs are skipped from then on.
+*
+------------------------------------------------------------------------------*/
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+#include <SDL2/SDL.h>
+#include <vector>
+#include <utility>
+
+#include "Category.h"
+#include "../basic/Entity.h"
+#include "../game/FlatMap.h"
+
+class Broadphase {
+public:
+    Broadphase() = default;
+    ~Broadphase() = default;
+
+    void begin(const int pReach);
+    void add(Entity *entity, const unsigned int category);
+    void build(const unsigned int apart);
+    void clear();
+    void addLate(Entity *entity, const unsigned int category);
+    void remove(const Entity *entity);
+    void reserve(const unsigned int n);
+
+    bool isValid() const {return valid;}
+    unsigned int getSize() const {return units.size();}
+    unsigned int getPairCount() const {return pairs.size() / 2;}
+
+    template<typename Visitor>
+    bool visitPairs(const Entity *entity, const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const;
+
+private:
+    struct Unit {
+        //movement hitbox when the pass was built
+        SDL_Rect box;
+        //box grown by the reach on every side
+        SDL_Rect grown;
+        Entity *entity;
+        //CollisionCategory bits of the unit, cleared once it is removed
+        unsigned int category;
+        bool friendly;
+    };
+
+    static bool contains(const SDL_Rect& outer, const SDL_Rect& inner);
+
+    bool valid = false;
+    int reach = 0;
+    //categories that are never checked against each other, from the last build
+    unsigned int apart = 0;
+    //units in the runs, any after them were added since the build
+    unsigned int paired = 0;
+    //sorted by the left edge of the grown box once built
+    std::vector<Unit> units;
+    //pairs of unit i are pairs[offsets[i]] up to pairs[offsets[i + 1]], each pair is stored once per unit
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> pairs;
+    FlatMap<const Entity *, unsigned int> indices;
+    //scratch space for the sweep
+    std::vector<unsigned int> active;
+    std::vector<std::pair<unsigned int, unsigned int>> found;
+};
+
+/**
+ * Function Interface: bool visitPairs(const Entity *entity, const SDL_Rect& rect, const unsigned int mask,
+ *          Visitor&& visitor) const
+ *      entity : Unit whose pairs are searched
+ *      rect : Area the unit can touch
+ *      mask : Categories to search
+ *      visitor : Called with every paired unit in the mask whose movement hitbox overlaps the rect
+ *
+ * Description:
+ *      Returns false without calling the visitor if the pass can't answer for the rect, either because
+ *      it is out of date, the entity is not in a run, or the rect leaves the entity's grown box.
+ *      The caller then has to search the grid instead. Otherwise returns true.
+ *      The visitor sees the same units a grid search of the rect would, tested against the same stored boxes.
+ *      Units added since the build are tested after the run.
+ */
+template<typename Visitor>
+bool Broadphase::visitPairs(const Entity *entity, const SDL_Rect& rect, const unsigned int mask,
+        Visitor&& visitor) const {
+    if (!valid) {
+        return false;
+    }
+    const unsigned int *const found = indices.get(entity);
+    if (!found || *found >= paired || !contains(units[*found].grown, rect)) {
+        return false;
+    }
+    const unsigned int index = *found;
+    const auto touches = [&rect, mask](const Unit& other) {
+        //same test as SDL_HasIntersection, stored boxes are never empty once paired
+        return (other.category & mask) && rect.x < other.box.x + other.box.w && other.box.x < rect.x + rect.w
+            && rect.y < other.box.y + other.box.h && other.box.y < rect.y + rect.h;
+    };
+    for (unsigned int i = offsets[index]; i < offsets[index + 1]; ++i) {
+        const Unit& other = units[pairs[i]];
+        if (touches(other)) {
+            visitor(other.entity);
+        }
+    }
+    //late units were never paired, so they get the pairing rules from build() here
+    const Unit& unit = units[index];
+    for (unsigned int i = paired; i < units.size(); ++i) {
+        const Unit& other = units[i];
+        if (!(unit.friendly && other.friendly) && ((unit.category | other.category) & ~apart) && touches(other)) {
+            visitor(other.entity);
+        }
+    }
+    return true;
+}
+
+#endif
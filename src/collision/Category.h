@@ -0,0 +1,51 @@
+/*------------------------------------------------------------------------------
+* Header: Category.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Category bits carried by every entry in the collision index. An entity that is
+*       more than one thing, like a store that can also be picked up, is stored once with
+*       several bits set. Queries take a mask and only see entries sharing a bit with it.
+*
+------------------------------------------------------------------------------*/
+#ifndef CATEGORY_H
+#define CATEGORY_H
+
+namespace CollisionCategory {
+    constexpr unsigned int NONE = 0;
+    constexpr unsigned int MARINE = 1u << 0;
+    constexpr unsigned int ZOMBIE = 1u << 1;
+    constexpr unsigned int WALL = 1u << 2;
+    constexpr unsigned int TURRET = 1u << 3;
+    constexpr unsigned int BARRICADE = 1u << 4;
+    constexpr unsigned int PICKUP = 1u << 5;
+    constexpr unsigned int STORE = 1u << 6;
+    constexpr unsigned int OBJ = 1u << 7;
+    constexpr unsigned int ALL = ~0u;
+
+    //which layer of the index holds each category
+    constexpr unsigned int UNITS = MARINE | ZOMBIE;
+    constexpr unsigned int STATIC = WALL;
+    constexpr unsigned int PLACED = TURRET | BARRICADE | PICKUP | STORE | OBJ;
+
+    //what stops a zombie from moving, marines are also stopped by zombies
+    constexpr unsigned int ZOMBIE_BLOCKERS = MARINE | WALL | TURRET | BARRICADE | STORE | OBJ;
+    constexpr unsigned int MARINE_BLOCKERS = ZOMBIE_BLOCKERS | ZOMBIE;
+    //what zombies go after
+    constexpr unsigned int TARGETS = MARINE | TURRET;
+    //what a barricade or turret can't be placed on top of
+    constexpr unsigned int BARRICADE_BLOCKERS = MARINE | ZOMBIE | WALL | TURRET | BARRICADE | OBJ;
+    constexpr unsigned int TURRET_BLOCKERS = BARRICADE_BLOCKERS | PICKUP | STORE;
+}
+
+#endif
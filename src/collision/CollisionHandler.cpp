@@ -18,6 +18,8 @@
 ------------------------------------------------------------------------------*/
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 #include <cassert>
 #include <omp.h>
 
@@ -25,6 +27,7 @@
 #include "CollisionHandler.h"
 #include "../player/Marine.h"
 #include "../log/log.h"
+#include "../map/Map.h"
 #include "../inventory/weapons/Target.h"
 
 /**
@@ -35,28 +38,49 @@
  * Description:
  * Constructor for Collision Handler
  */
-CollisionHandler::CollisionHandler() : zombieMovementTree(0, {0,0,2000,2000}), marineTree(0, {0,0,2000,2000}),
-        zombieTree(0, {0,0,2000,2000}), barricadeTree(0, {0,0,2000,2000}),turretTree(0, {0,0,2000,2000}),
-        wallTree(0, {0,0,2000,2000}), pickUpTree(0, {0,0,2000,2000}), objTree(0, {0,0,2000,2000}),
-        storeTree(0,{0,0,2000,2000}) {
+CollisionHandler::CollisionHandler() : CollisionHandler({0, 0, MAP_WIDTH, MAP_HEIGHT}) {
 
 }
 
+/**
+ * Function Interface: CollisionHandler::CollisionHandler(const SDL_Rect& mapBounds)
+ *      mapBounds : Area covered by the index
+ *
+ * Description:
+ * Constructor for Collision Handler covering a specific area
+ */
+CollisionHandler::CollisionHandler(const SDL_Rect& mapBounds)
+        : unitGrid(mapBounds, T_SIZE), placedTree(mapBounds, Quadtree::levelsFor(mapBounds, T_SIZE)) {
+
+}
+
+/**
+ * Function Interface: void CollisionHandler::setMapBounds(const SDL_Rect& mapBounds)
+ *      mapBounds : Area covered by the loaded map
+ *
+ * Description:
+ * Resizes every layer of the index to cover the loaded map. Empties all of them.
+ */
+void CollisionHandler::setMapBounds(const SDL_Rect& mapBounds) {
+    unitGrid.reset(mapBounds, T_SIZE);
+    wallBVH.clear();
+    placedTree.reset(mapBounds, Quadtree::levelsFor(mapBounds, T_SIZE));
+    unitPairs.clear();
+}
+
 /**
  * Date: Feb. 4, 2017
  * Modified: Mar. 15 2017 - Mark Tattrie
  * Author: Jacob McPhail.
- * Function Interface: const HitBox *CollisionHandler::detectDamageCollision(std::vector<Entity*>
+ * Function Interface: const Entity *CollisionHandler::detectDamageCollision(const std::vector<Entity*>&
  *      returnObjects, const Entity *entity) {
  * Description:
- * Check for projectile collisions, return hitbox it hits
+ * Check for projectile collisions. Returns the entity hit, or nullptr
  */
-const HitBox *CollisionHandler::detectDamageCollision(std::vector<Entity*> returnObjects, const Entity *entity) {
+const Entity *CollisionHandler::detectDamageCollision(const std::vector<Entity*>& returnObjects, const Entity *entity) {
     for (const auto& obj: returnObjects) {
-        if (obj && entity != obj
-            && SDL_HasIntersection(&entity->getDamHitBox().getRect(), &obj->getDamHitBox().getRect())
-                && !(entity->getDamHitBox().isPlayerFriendly() && obj->getDamHitBox().isPlayerFriendly())) {
-            return &obj->getDamHitBox();
+        if (damageHit(entity, obj)) {
+            return obj;
         }
     }
     return nullptr;
@@ -66,17 +90,15 @@ const HitBox *CollisionHandler::detectDamageCollision(std::vector<Entity*> retur
  * Date: Feb. 4, 2017
  * Modified: Mar. 15 2017 - Mark Tattrie
  * Author: Jacob McPhail.
- * Function Interface: const HitBox *CollisionHandler::detectProjectileCollision(std::vector<Entity*>
+ * Function Interface: const Entity *CollisionHandler::detectProjectileCollision(const std::vector<Entity*>&
  *      returnObjects, const Entity *entity) {
  * Description:
- * Check for projectile collisions, return object it hits
+ * Check for projectile collisions. Returns the entity hit, or nullptr
  */
-const HitBox *CollisionHandler::detectProjectileCollision(std::vector<Entity*> returnObjects, const Entity *entity) {
+const Entity *CollisionHandler::detectProjectileCollision(const std::vector<Entity*>& returnObjects, const Entity *entity) {
     for (const auto& obj: returnObjects) {
-        if (obj && entity != obj
-            && SDL_HasIntersection(&entity->getProHitBox().getRect(), &obj->getProHitBox().getRect())
-                && !(entity->getProHitBox().isPlayerFriendly() && obj->getProHitBox().isPlayerFriendly())) {
-            return &(obj->getProHitBox());
+        if (projectileHit(entity, obj)) {
+            return obj;
         }
     }
     return nullptr;
@@ -86,22 +108,323 @@ const HitBox *CollisionHandler::detectProjectileCollision(std::vector<Entity*> r
  * Date: Feb. 4, 2017
  * Modified: Mar. 15 2017 - Mark Tattrie
  * Author: Jacob McPhail.
- * Function Interface: bool CollisionHandler::detectMovementCollision(std::vector<Entity*> returnObjects,
+ * Function Interface: bool CollisionHandler::detectMovementCollision(const std::vector<Entity*>& returnObjects,
  *       const Entity *entity)
  * Description:
  * Check for collisions during movement
  */
-bool CollisionHandler::detectMovementCollision(std::vector<Entity*> returnObjects, const Entity *entity) {
+bool CollisionHandler::detectMovementCollision(const std::vector<Entity*>& returnObjects, const Entity *entity) {
     for (const auto& obj: returnObjects) {
-        if (obj && entity != obj
-            && SDL_HasIntersection(&entity->getMoveHitBox().getRect(), &obj->getMoveHitBox().getRect())
-                && !(entity->getMoveHitBox().isPlayerFriendly() && obj->getMoveHitBox().isPlayerFriendly())) {
+        if (movementHit(entity, obj)) {
             return true;
         }
     }
     return false;
 }
 
+/**
+ * Function Interface: bool detectMovementCollision(const unsigned int mask, const Entity *entity) const
+ *      mask : Categories to check against
+ *      entity : Entity to check
+ *
+ * Description:
+ * Check for collisions during movement without building a list, stops at the first hit.
+ * Marines and zombies are checked against the movement hitboxes stored in the grid a whole
+ * block at a time, so the entities themselves are only touched to rule out the entity
+ * colliding with itself.
+ */
+bool CollisionHandler::detectMovementCollision(const unsigned int mask, const Entity *entity) const {
+    const HitBox box = entity->getMoveHitBox();
+    if ((mask & CollisionCategory::UNITS) && unitGrid.visitOverlapping(box.getRect(), box.isPlayerFriendly(), mask,
+            [entity](const Entity *obj) {
+                return obj != entity;
+            })) {
+        return true;
+    }
+    return visit(box.getRect(), mask & ~CollisionCategory::UNITS, [entity](const Entity *obj) {
+        return movementHit(entity, obj);
+    });
+}
+
+/**
+ * Function Interface: bool detectMovementCollision(const unsigned int mask, const SDL_Rect& box) const
+ *      mask : Categories to check against
+ *      box : Movement hitbox to check
+ *
+ * Description:
+ * Check whether a movement hitbox placed at box would collide with anything in the mask, so a spot can
+ * be tested before anything is created there. The box is not player friendly.
+ */
+bool CollisionHandler::detectMovementCollision(const unsigned int mask, const SDL_Rect& box) const {
+    if ((mask & CollisionCategory::UNITS) && unitGrid.visitOverlapping(box, false, mask, [](const Entity *) {
+                return true;
+            })) {
+        return true;
+    }
+    return visit(box, mask & ~CollisionCategory::UNITS, [&box](const Entity *obj) {
+        return obj && SDL_HasIntersection(&box, &obj->getMoveHitBox().getRect());
+    });
+}
+
+/**
+ * Function Interface: const Entity *detectDamageCollision(const unsigned int mask, const Entity *entity) const
+ *      mask : Categories to check against
+ *      entity : Entity to check
+ *
+ * Description:
+ * Check for damage collisions without building a list, return the first entity whose hitbox it hits
+ */
+const Entity *CollisionHandler::detectDamageCollision(const unsigned int mask, const Entity *entity) const {
+    const Entity *hit = nullptr;
+    visit(entity->getDamHitBox().getRect(), mask, [entity, &hit](const Entity *obj) {
+        if (damageHit(entity, obj)) {
+            hit = obj;
+            return true;
+        }
+        return false;
+    });
+    return hit;
+}
+
+/**
+ * Function Interface: const Entity *detectProjectileCollision(const unsigned int mask, const Entity *entity) const
+ *      mask : Categories to check against
+ *      entity : Entity to check
+ *
+ * Description:
+ * Check for projectile collisions without building a list, return the first entity whose hitbox it hits
+ */
+const Entity *CollisionHandler::detectProjectileCollision(const unsigned int mask, const Entity *entity) const {
+    const Entity *hit = nullptr;
+    visit(entity->getProHitBox().getRect(), mask, [entity, &hit](const Entity *obj) {
+        if (projectileHit(entity, obj)) {
+            hit = obj;
+            return true;
+        }
+        return false;
+    });
+    return hit;
+}
+
+/**
+ * Function Interface: Entity *detectPickUpCollision(const unsigned int mask, const Entity *entity) const
+ *      mask : Categories to check against
+ *      entity : Entity to check
+ *
+ * Description:
+ * Check for pickup collision without building a list, return the first object it can pick up
+ */
+Entity *CollisionHandler::detectPickUpCollision(const unsigned int mask, const Entity *entity) const {
+    Entity *hit = nullptr;
+    visit(entity->getMoveHitBox().getRect(), mask, [entity, &hit](Entity *obj) {
+        if (pickUpHit(entity, obj)) {
+            hit = obj;
+            return true;
+        }
+        return false;
+    });
+    if (!hit) {
+        logv("nothing to pick up\n");
+    }
+    return hit;
+}
+
+/**
+ * Function Interface: void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+ *          const unsigned int mask) const
+ *      retrieveList : List the found entities are appended to
+ *      rect : Area to search
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ * Appends everything in the mask that could touch the rect.
+ */
+void CollisionHandler::retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+        const unsigned int mask) const {
+    visit(rect, mask, [&retrieveList](Entity *e) {
+        retrieveList.push_back(e);
+        return false;
+    });
+}
+
+/**
+ * Function Interface: std::pair<float, float> sweepMovement(const Entity *entity, const float moveX,
+ *          const float moveY, const unsigned int mask) const
+ *      entity : Entity that is moving
+ *      moveX : Distance to move horizontally
+ *      moveY : Distance to move vertically
+ *      mask : Categories that can block the entity
+ *
+ * Description:
+ * The index is searched once over the whole area the move covers, then the move is resolved
+ * against that list. Being stopped on one axis does not stop the other, so entities slide along
+ * whatever they hit, and nothing can be skipped over no matter how far the entity moves.
+ * Returns the position the entity should be moved to.
+ */
+std::pair<float, float> CollisionHandler::sweepMovement(const Entity *entity, const float moveX, const float moveY,
+        const unsigned int mask) const {
+    return sweepMovement(entity, entity->getMoveHitBox(), entity->getX(), entity->getY(), moveX, moveY, mask);
+}
+
+/**
+ * Function Interface: std::pair<float, float> sweepMovement(const Entity *entity, const HitBox& box,
+ *          const float x, const float y, const float moveX, const float moveY, const unsigned int mask) const
+ *      entity : Entity that is moving
+ *      box : Its movement hitbox
+ *      x : Its x position
+ *      y : Its y position
+ *      moveX : Distance to move horizontally
+ *      moveY : Distance to move vertically
+ *      mask : Categories that can block the entity
+ *
+ * Description:
+ * Does the work of the other sweepMovement, for callers that keep the position and hitbox of the
+ * entity themselves. Returns the position the entity should be moved to.
+ */
+std::pair<float, float> CollisionHandler::sweepMovement(const Entity *entity, const HitBox& box, const float x,
+        const float y, const float moveX, const float moveY, const unsigned int mask) const {
+    //movement runs in omp tasks so each thread keeps its own list
+    thread_local std::vector<SDL_Rect> blockers;
+    blockers.clear();
+
+    const SDL_Rect swept = sweptBox(box.getRect(), x, y, moveX, moveY);
+    gatherBlockers(mask, swept, entity, box.isPlayerFriendly(), blockers);
+    return resolveSweep(box.getRect(), x, y, moveX, moveY, blockers);
+}
+
+/**
+ * Function Interface: SDL_Rect sweptBox(const SDL_Rect& box, const float x, const float y, const float moveX,
+ *          const float moveY)
+ *      box : Movement hitbox of the entity
+ *      x : x position of the entity
+ *      y : y position of the entity
+ *      moveX : Distance to move horizontally
+ *      moveY : Distance to move vertically
+ *
+ * Description:
+ * Returns the area covered by the movement hitbox over the whole move
+ */
+SDL_Rect CollisionHandler::sweptBox(const SDL_Rect& box, const float x, const float y, const float moveX,
+        const float moveY) {
+    const int left = std::floor(std::min(x, x + moveX));
+    const int top = std::floor(std::min(y, y + moveY));
+    const int right = std::floor(std::max(x, x + moveX)) + box.w;
+    const int bottom = std::floor(std::max(y, y + moveY)) + box.h;
+    return {left, top, right - left, bottom - top};
+}
+
+/**
+ * Function Interface: void gatherBlockers(const unsigned int mask, const SDL_Rect& swept, const Entity *entity,
+ *          const bool friendly, std::vector<SDL_Rect>& blockers) const
+ *      mask : Categories that can block the entity
+ *      swept : Area the movement hitbox passes through
+ *      entity : Entity that is moving
+ *      friendly : Whether its movement hitbox is player friendly
+ *      blockers : List the movement hitboxes in the way are appended to
+ *
+ * Description:
+ * Collects the movement hitboxes inside the swept area that the entity can collide with.
+ * Marines and zombies come from the entity's pairs when the swept area stays inside what the pairs
+ * were built for, otherwise from the block test on the hitboxes stored in the grid.
+ */
+void CollisionHandler::gatherBlockers(const unsigned int mask, const SDL_Rect& swept, const Entity *entity,
+        const bool friendly, std::vector<SDL_Rect>& blockers) const {
+    if (mask & CollisionCategory::UNITS) {
+        const auto block = [entity, &blockers](const Entity *obj) {
+            if (obj != entity) {
+                blockers.push_back(obj->getMoveHitBox().getRect());
+            }
+            return false;
+        };
+        if (!unitPairs.visitPairs(entity, swept, mask, block)) {
+            unitGrid.visitOverlapping(swept, friendly, mask, block);
+        }
+    }
+    visit(swept, mask & ~CollisionCategory::UNITS, [entity, friendly, &swept, &blockers](const Entity *obj) {
+        if (obj && obj != entity && !(friendly && obj->getMoveHitBox().isPlayerFriendly())
+                && SDL_HasIntersection(&swept, &obj->getMoveHitBox().getRect())) {
+            blockers.push_back(obj->getMoveHitBox().getRect());
+        }
+        return false;
+    });
+}
+
+/**
+ * Function Interface: std::pair<float, float> resolveSweep(const SDL_Rect& box, const float x, const float y,
+ *          const float moveX, const float moveY, const std::vector<SDL_Rect>& blockers)
+ *      box : Movement hitbox of the entity
+ *      x : x position of the entity
+ *      y : y position of the entity
+ *      moveX : Distance to move horizontally
+ *      moveY : Distance to move vertically
+ *      blockers : Movement hitboxes that can be in the way
+ *
+ * Description:
+ * Sweeps the horizontal part of the move and then the vertical part from where that ended,
+ * the same order the moves were checked in before. Returns the position reached.
+ */
+std::pair<float, float> CollisionHandler::resolveSweep(const SDL_Rect& box, const float x, const float y,
+        const float moveX, const float moveY, const std::vector<SDL_Rect>& blockers) {
+    //an empty hitbox never collides with anything
+    if (box.w <= 0 || box.h <= 0) {
+        return {x + moveX, y + moveY};
+    }
+    const float toX = sweepAxis(x, moveX, y, box.w, box.h, blockers, true);
+    const float toY = sweepAxis(y, moveY, toX, box.h, box.w, blockers, false);
+    return {toX, toY};
+}
+
+/**
+ * Function Interface: float sweepAxis(const float from, const float delta, const float across, const int size,
+ *          const int acrossSize, const std::vector<SDL_Rect>& blockers, const bool horizontal)
+ *      from : Starting position along the axis
+ *      delta : Distance to move along the axis
+ *      across : Position on the other axis
+ *      size : Size of the moving hitbox along the axis
+ *      acrossSize : Size of the moving hitbox on the other axis
+ *      blockers : Movement hitboxes that can be in the way
+ *      horizontal : Whether the axis is x
+ *
+ * Description:
+ * Moves along one axis until the first box in the way. Hitboxes sit at the whole pixel
+ * below the position, so a box is entered once the position reaches enter and left once
+ * it reaches leave. Moving forward stops on the last float before enter, moving back stops
+ * on leave, which leaves the hitboxes touching but not overlapping.
+ * Boxes the entity already overlaps are ignored so it can walk out of them.
+ */
+float CollisionHandler::sweepAxis(const float from, const float delta, const float across, const int size,
+        const int acrossSize, const std::vector<SDL_Rect>& blockers, const bool horizontal) {
+    if (delta == 0) {
+        return from;
+    }
+    float to = from + delta;
+    const int acrossPixel = std::floor(across);
+
+    for (const auto& b : blockers) {
+        const int low = horizontal ? b.x : b.y;
+        const int length = horizontal ? b.w : b.h;
+        const int acrossLow = horizontal ? b.y : b.x;
+        const int acrossLength = horizontal ? b.h : b.w;
+        if (length <= 0 || acrossLength <= 0) {
+            continue;
+        }
+        //only boxes level with the entity can be hit along this axis
+        if (acrossPixel <= acrossLow - acrossSize || acrossPixel >= acrossLow + acrossLength) {
+            continue;
+        }
+        const int enter = low - size + 1;
+        const int leave = low + length;
+        if (delta > 0) {
+            if (from < enter && to >= enter) {
+                to = std::nextafter(static_cast<float>(enter), -HUGE_VALF);
+            }
+        } else if (from >= leave && to < leave) {
+            to = leave;
+        }
+    }
+    return to;
+}
+
 bool CollisionHandler::detectStoreCollision(const Entity* player, const Entity* store){
     return SDL_HasIntersection(&store->getPickUpHitBox().getRect(), &player->getMoveHitBox().getRect());
 }
@@ -111,16 +434,14 @@ bool CollisionHandler::detectStoreCollision(const Entity* player, const Entity*
  * Date: Mar. 1, 2017
  * Modified: Mar. 15 2017 - Mark Tattrie
  * Author: Maitiu Morton.
- * Function Interface: Entity *CollisionHandler::detectPickUpCollision(std::vector<Entity*> returnObjects,
+ * Function Interface: Entity *CollisionHandler::detectPickUpCollision(const std::vector<Entity*>& returnObjects,
  *       const Entity *entity)
  * Description:
  * Check for pickup collision
  */
-Entity *CollisionHandler::detectPickUpCollision(std::vector<Entity*> returnObjects, const Entity *entity) {
+Entity *CollisionHandler::detectPickUpCollision(const std::vector<Entity*>& returnObjects, const Entity *entity) {
     for (const auto& obj: returnObjects) {
-        if (obj && entity != obj
-            && SDL_HasIntersection(&entity->getMoveHitBox().getRect(), &obj->getPickUpHitBox().getRect())
-                && !(entity->getMoveHitBox().isPlayerFriendly() && obj->getPickUpHitBox().isPlayerFriendly())) {
+        if (pickUpHit(entity, obj)) {
             return obj;
         }
     }
@@ -133,7 +454,10 @@ Entity *CollisionHandler::detectPickUpCollision(std::vector<Entity*> returnObjec
 
     DISCRIPTION:
         This checks each relevent quadTrees for targets that are in the weapons sights,
-        and adds them to a priority queue that is sorted by distance from the player.
+        and adds them to the target list sorted by distance from the player.
+        Only the closest wall matters since nothing gets past it. Zombies are found by walking
+        the grid along the line, which stops once penetration + 1 zombies or the wall are
+        known to be closer than anything left to search.
 
     AUTHOR: Deric Mccadden 3/8/2017
         Edited: 3/16/2017 fixed to use new quad trees (cant shoot walls yet)
@@ -142,7 +466,7 @@ Entity *CollisionHandler::detectPickUpCollision(std::vector<Entity*> returnObjec
 
     PARAMS:
         TargetList &targetList,
-            This is the priority queue wrapper that will hold the targets that will be determined.
+            The sorted list that will hold the targets that will be determined.
 
         const int gunX, const int gunY,
             coordinates of the weapons muzzle.
@@ -152,31 +476,241 @@ Entity *CollisionHandler::detectPickUpCollision(std::vector<Entity*> returnObjec
 
         const int range
             The range of the weapon that is being fired.
+
+        const int penetration
+            How many zombies the shot can pass through.
 */
 void CollisionHandler::detectLineCollision(TargetList& targetList, const int gunX, const int gunY,
-        const double angle, const int range) {
+        const double angle, const int range, const int penetration) {
 
-    const double degrees = angle - 90;
-    const double radians = degrees * M_PI / 180;
-    const int deltaX = range * cos(radians);
-    const int deltaY = range * sin(radians);
-    const int endX = gunX + deltaX;
-    const int endY = gunY + deltaY;
+    int endX;
+    int endY;
+    lineEnd(gunX, gunY, angle, range, endX, endY);
+    const int deltaX = endX - gunX;
+    const int deltaY = endY - gunY;
 
     targetList.setOriginX(gunX);
     targetList.setOriginY(gunY);
     targetList.setEndX(endX);
     targetList.setEndY(endY);
 
-    const auto& nearbyZombies = zombieTree.retrieve({gunX, gunY}, {endX, endY});
-    const auto& nearbyWalls = wallTree.retrieve({gunX, gunY}, {endX, endY});
-
-    checkForTargetsInVector(gunX, gunY, endX, endY, targetList, nearbyZombies, TYPE_ZOMBIE);
-    checkForTargetsInVector(gunX, gunY, endX, endY, targetList, nearbyWalls, TYPE_WALL);
+    const Point start(gunX, gunY);
+    const Point end(endX, endY);
+
+    //the closest wall
+    int32_t wallId = 0;
+    int wallX = 0;
+    int wallY = 0;
+    int wallDist = std::numeric_limits<int>::max();
+    wallBVH.visit(start, end, CollisionCategory::WALL, [&](const Entity *wall) {
+        int hitX;
+        int hitY;
+        int dist;
+        if (lineHit(wall, gunX, gunY, endX, endY, hitX, hitY, dist) && dist < wallDist) {
+            wallId = wall->getId();
+            wallX = hitX;
+            wallY = hitY;
+            wallDist = dist;
+        }
+        return false;
+    });
+
+    //the grid walk can run from several threads at once
+    thread_local std::vector<Target> zombies;
+    zombies.clear();
+    const float length = std::hypot(deltaX, deltaY);
+
+    unitGrid.traceRay(start, end, CollisionCategory::ZOMBIE, [&](const Entity *zombie) {
+        int hitX;
+        int hitY;
+        int dist;
+        if (lineHit(zombie, gunX, gunY, endX, endY, hitX, hitY, dist) && dist < wallDist) {
+            zombies.emplace_back(zombie->getId(), TYPE_ZOMBIE, hitX, hitY, dist);
+        }
+    }, [&](const float reached) {
+        //hit points are rounded to whole pixels, so leave a little room before calling a hit settled
+        const int settled = reached * length - LINE_HIT_MARGIN;
+        if (wallDist <= settled) {
+            return true;
+        }
+        return std::count_if(zombies.begin(), zombies.end(), [settled](const Target& t) {
+            return t.getPlayerDist() <= settled;
+        }) > penetration;
+    });
+
+    std::stable_sort(zombies.begin(), zombies.end(), [](const Target& lhs, const Target& rhs) {
+        return lhs.getPlayerDist() < rhs.getPlayerDist();
+    });
+    for (const auto& t : zombies) {
+        targetList.addTarget(t);
+    }
+    if (wallDist != std::numeric_limits<int>::max()) {
+        targetList.addTarget(Target(wallId, TYPE_WALL, wallX, wallY, wallDist));
+    }
 
     logv(3, "CollisionHandler::detectLineCollision() targetsInSights.size(): %d\n", targetList.numTargets());
 }
 
+/**
+ * Function Interface: void lineEnd(const int gunX, const int gunY, const double angle, const int range,
+ *          int& endX, int& endY)
+ *      gunX, gunY : Coordinates of the weapons muzzle
+ *      angle : Angle the weapon is facing
+ *      range : Range of the weapon
+ *      endX, endY : Set to the furthest point the bullet can travel
+ *
+ * Description:
+ * Works out where a shot ends if it hits nothing
+ */
+void CollisionHandler::lineEnd(const int gunX, const int gunY, const double angle, const int range,
+        int& endX, int& endY) {
+    const double degrees = angle - 90;
+    const double radians = degrees * M_PI / 180;
+    const int deltaX = range * cos(radians);
+    const int deltaY = range * sin(radians);
+    endX = gunX + deltaX;
+    endY = gunY + deltaY;
+}
+
+/**
+ * Function Interface: void detectConeCollision(std::vector<TargetList>& targetLists, const int gunX,
+ *          const int gunY, const double angle, const double coneAngle, const int range)
+ *      targetLists : One list per pellet, filled with that pellets targets closest first
+ *      gunX, gunY : Coordinates of the weapons muzzle
+ *      angle : Angle the weapon is facing
+ *      coneAngle : How far the pellets spread out, they are evenly spaced starting from one edge
+ *      range : Range of the weapon
+ *
+ * Description:
+ * Finds the targets of every pellet of a spread at once. The walls and zombies inside the box
+ * covering all the pellets are gathered in one search of each tree, then every candidate is
+ * slab tested against all the pellets in a single loop before the pellets that might cross it
+ * are clipped exactly. Each list ends up the same as detectLineCollision would make it, apart
+ * from also holding every zombie before the wall, since zombies killed by an earlier pellet
+ * are still listed and get passed over.
+ */
+void CollisionHandler::detectConeCollision(std::vector<TargetList>& targetLists, const int gunX, const int gunY,
+        const double angle, const double coneAngle, const int range) {
+    const unsigned int shots = targetLists.size();
+    if (!shots) {
+        return;
+    }
+
+    //pellet ends and the reciprocal of each pellets direction for the slab test
+    thread_local std::vector<int> endX;
+    thread_local std::vector<int> endY;
+    thread_local std::vector<float> invX;
+    thread_local std::vector<float> invY;
+    thread_local std::vector<char> crosses;
+    endX.resize(shots);
+    endY.resize(shots);
+    invX.resize(shots);
+    invY.resize(shots);
+    crosses.resize(shots);
+
+    const double seperation = coneAngle / shots;
+    double currentAngle = angle - (coneAngle / 2);
+    int left = gunX;
+    int top = gunY;
+    int right = gunX;
+    int bottom = gunY;
+    for (unsigned int i = 0; i < shots; ++i) {
+        lineEnd(gunX, gunY, currentAngle, range, endX[i], endY[i]);
+        currentAngle += seperation;
+
+        const int dx = endX[i] - gunX;
+        const int dy = endY[i] - gunY;
+        //a huge value stands in for dividing by zero, 0 * max is still 0 so no NaNs come out of the test
+        invX[i] = dx ? 1.0f / dx : std::numeric_limits<float>::max();
+        invY[i] = dy ? 1.0f / dy : std::numeric_limits<float>::max();
+
+        left = std::min(left, endX[i]);
+        top = std::min(top, endY[i]);
+        right = std::max(right, endX[i]);
+        bottom = std::max(bottom, endY[i]);
+
+        targetLists[i].setOriginX(gunX);
+        targetLists[i].setOriginY(gunY);
+        targetLists[i].setEndX(endX[i]);
+        targetLists[i].setEndY(endY[i]);
+    }
+
+    //one search of each tree for the whole spread, a pixel wider for SDL rounding
+    const SDL_Rect area = {left - 1, top - 1, right - left + 3, bottom - top + 3};
+    thread_local std::vector<Entity *> walls;
+    thread_local std::vector<Entity *> zombies;
+    walls.clear();
+    zombies.clear();
+    wallBVH.retrieve(walls, area, CollisionCategory::WALL);
+    unitGrid.retrieve(zombies, area, CollisionCategory::ZOMBIE);
+
+    //closest wall of each pellet
+    thread_local std::vector<Target> wallHits;
+    wallHits.assign(shots, Target(0, TYPE_WALL, 0, 0, std::numeric_limits<int>::max()));
+    //zombie hits of every pellet, tagged with the pellet
+    thread_local std::vector<std::pair<unsigned int, Target>> zombieHits;
+    zombieHits.clear();
+
+    const auto checkPellets = [&](const Entity *e, const int type) {
+        const SDL_Rect box = e->getProHitBox().getRect();
+        const float boxLeft = box.x - 1 - gunX;
+        const float boxRight = box.x + box.w + 1 - gunX;
+        const float boxTop = box.y - 1 - gunY;
+        const float boxBottom = box.y + box.h + 1 - gunY;
+
+        for (unsigned int i = 0; i < shots; ++i) {
+            const float x1 = boxLeft * invX[i];
+            const float x2 = boxRight * invX[i];
+            const float y1 = boxTop * invY[i];
+            const float y2 = boxBottom * invY[i];
+            const float enter = std::max(std::max(std::min(x1, x2), std::min(y1, y2)), 0.0f);
+            const float leave = std::min(std::min(std::max(x1, x2), std::max(y1, y2)), 1.0f);
+            crosses[i] = enter <= leave;
+        }
+
+        for (unsigned int i = 0; i < shots; ++i) {
+            int hitX;
+            int hitY;
+            int dist;
+            if (!crosses[i] || !lineHit(e, gunX, gunY, endX[i], endY[i], hitX, hitY, dist)) {
+                continue;
+            }
+            if (type == TYPE_WALL) {
+                if (dist < wallHits[i].getPlayerDist()) {
+                    wallHits[i] = Target(e->getId(), TYPE_WALL, hitX, hitY, dist);
+                }
+            } else {
+                zombieHits.emplace_back(i, Target(e->getId(), TYPE_ZOMBIE, hitX, hitY, dist));
+            }
+        }
+    };
+    for (const auto w : walls) {
+        checkPellets(w, TYPE_WALL);
+    }
+    for (const auto z : zombies) {
+        checkPellets(z, TYPE_ZOMBIE);
+    }
+
+    std::stable_sort(zombieHits.begin(), zombieHits.end(),
+        [](const std::pair<unsigned int, Target>& lhs, const std::pair<unsigned int, Target>& rhs) {
+            return lhs.first < rhs.first
+                || (lhs.first == rhs.first && lhs.second.getPlayerDist() < rhs.second.getPlayerDist());
+        });
+    for (const auto& hit : zombieHits) {
+        if (hit.second.getPlayerDist() < wallHits[hit.first].getPlayerDist()) {
+            targetLists[hit.first].addTarget(hit.second);
+        }
+    }
+    for (unsigned int i = 0; i < shots; ++i) {
+        if (wallHits[i].getPlayerDist() != std::numeric_limits<int>::max()) {
+            targetLists[i].addTarget(wallHits[i]);
+        }
+    }
+
+    logv(3, "CollisionHandler::detectConeCollision() %d hits for %d pellets\n",
+        static_cast<int>(zombieHits.size()), shots);
+}
+
 /**
  * Date: Mar. 28, 2017
  * Author: Mark Tattrie
@@ -197,15 +731,18 @@ std::vector<Entity *> CollisionHandler::detectMeleeCollision(const std::vector<E
 }
 
 /**
-    checkTargets
+    lineHit
 
     DISCRIPTION:
-        This checks a single vector of *hitboxes for targets that are in the weapons sights,
-        and adds them to a priority queue that is sorted by distance from the player.
+        This checks a single entity for being in the weapons sights and works out
+        where the bullet enters it and how far that is from the gun.
 
     AUTHOR: Deric Mccadden 3/16/2017
 
     PARAMS:
+        const Entity *entity,
+            The entity to check.
+
         const int gunX,
         const int gunY,
             The x and y where the bullet is fired from.
@@ -214,117 +751,259 @@ std::vector<Entity *> CollisionHandler::detectMeleeCollision(const std::vector<E
         const int endY,
             The furthest point the bullet can travel.
 
-        TargetList &targetList,
-            This is the priority queue wrapper that will hold the targets that will be determined.
-
-        std::vector<Entity*> allEntities,
-            The entities that will need to be searched for valid targets.
-
-        int type
-            the type of entity, see target Target.h for definitions.
-            This is needed for identification purposes in InstantWeapon.fire()
+        int& hitX,
+        int& hitY,
+        int& dist
+            Set to where the bullet hits the entity and its distance from the gun.
 */
-void CollisionHandler::checkForTargetsInVector(const int gunX, const int gunY, const int endX, const int endY,
-        TargetList& targetList, const std::vector<Entity *>& allEntities, const int type) const {
-
-#pragma omp parallel for schedule(static) shared(targetList)
-    for(unsigned int i = 0; i < allEntities.size(); ++i) {
-
-        /* These values are initialized to the end points of a line spanning from the gun muzzle
-        to the point at the end of the guns range. After SDL_IntersectRectAndLine is called
-        they are changed to the end points of a line that intersects the hitbox starting with
-        the entrance wound and ending with the exit wound as if the bullet were to pass straight
-        through the hitbox and exit on the other side while maintaing its starting trajectory.
-        This is why they are not const as the function has to be able to change them. */
-        int entranceWoundX = gunX;
-        int entranceWoundY = gunY;
-        int exitWoundX = endX;
-        int exitWoundY = endY;
-
-        if (SDL_IntersectRectAndLine(&allEntities[i]->getProHitBox().getRect(),
-                &entranceWoundX, &entranceWoundY , &exitWoundX, &exitWoundY)) {
-
-            //the change in x and y from the firing origin to the spot the bullet hits the target.
-            const int localDeltaX = entranceWoundX - gunX;
-            const int localDeltaY = entranceWoundY - gunY;
-            //the direct distance from the firing origin to the spot the bullet hits each target.
-            const int distanceToOrigin = std::hypot(localDeltaX, localDeltaY);
-
-            Target tar(allEntities[i]->getId(), type, entranceWoundX, entranceWoundY, distanceToOrigin);
-#pragma omp critical
-            targetList.addTarget(tar);
-
-            logv(3, "CollisionHandler::checkTargets() Intersect target at (%d, %d)\n",
-                entranceWoundX, entranceWoundY);
-            logv(3, "CollisionHandler::checkTargets() distanceToOrigin %d\n", distanceToOrigin);
-            logv(3, "CollisionHandler::checkTargets() tar.getType(): %d\n", tar.getType());
-        }
+bool CollisionHandler::lineHit(const Entity *entity, const int gunX, const int gunY, const int endX, const int endY,
+        int& hitX, int& hitY, int& dist) {
+
+    /* These values are initialized to the end points of a line spanning from the gun muzzle
+    to the point at the end of the guns range. After SDL_IntersectRectAndLine is called
+    they are changed to the end points of a line that intersects the hitbox starting with
+    the entrance wound and ending with the exit wound as if the bullet were to pass straight
+    through the hitbox and exit on the other side while maintaing its starting trajectory.
+    This is why they are not const as the function has to be able to change them. */
+    int entranceWoundX = gunX;
+    int entranceWoundY = gunY;
+    int exitWoundX = endX;
+    int exitWoundY = endY;
+
+    if (!SDL_IntersectRectAndLine(&entity->getProHitBox().getRect(),
+            &entranceWoundX, &entranceWoundY , &exitWoundX, &exitWoundY)) {
+        return false;
     }
+
+    hitX = entranceWoundX;
+    hitY = entranceWoundY;
+    //the direct distance from the firing origin to the spot the bullet hits the target.
+    dist = std::hypot(entranceWoundX - gunX, entranceWoundY - gunY);
+
+    logv(3, "CollisionHandler::lineHit() Intersect target at (%d, %d)\n", hitX, hitY);
+    logv(3, "CollisionHandler::lineHit() distanceToOrigin %d\n", dist);
+    return true;
 }
 
 
 /**
  * Date: Mar. 15, 2017
  * Author: Mark Tattrie
- * Function Interface: std::vector<Entity *> CollisionHandler::getQuadTreeEntities(Quadtree& q,
+ * Function Interface: std::vector<Entity *> CollisionHandler::getQuadTreeEntities(const unsigned int mask,
  *      const Entity *entity)
  * Description:
- * Wrapper to grab a vector of entities from the specified quadtree
+ * Wrapper to grab a vector of entities in the given categories near the entity
  */
-std::vector<Entity *> CollisionHandler::getQuadTreeEntities(const Quadtree& q, const Entity *entity) const {
-    return q.retrieve(entity);
+std::vector<Entity *> CollisionHandler::getQuadTreeEntities(const unsigned int mask, const Entity *entity) const {
+    std::vector<Entity *> retrieved;
+    if (entity) {
+        retrieve(retrieved, Quadtree::getExtent(entity), mask);
+    }
+    return retrieved;
+}
+
+void CollisionHandler::reserveUnits(const unsigned int n) {
+#pragma omp critical(collisionIndex)
+    {
+        unitGrid.reserve(n);
+        unitPairs.reserve(n);
+    }
 }
 
 void CollisionHandler::clear() {
-    zombieMovementTree.clear();
-    marineTree.clear();
-    zombieTree.clear();
-    barricadeTree.clear();
-    turretTree.clear();
-    pickUpTree.clear();
-    objTree.clear();
-    storeTree.clear();
+    unitGrid.clear();
+    wallBVH.clear();
+    placedTree.clear();
+    unitPairs.clear();
 }
 
+/*
+ * Inserting an entity that is already in the index moves it to its new node if it has changed cells,
+ * so the insert functions double as the per frame update for anything that moves.
+ * Each entity has a single entry, inserting it under another category adds that category to the entry
+ * and removing it only takes that category off, so a store that is also a pickup is stored once.
+ */
 void CollisionHandler::insertMarine(Entity *e) {
-    insertZombieMovementEntity(e);
-    marineTree.insert(e);
+    insertUnit(e, CollisionCategory::MARINE);
 }
 
 void CollisionHandler::insertZombie(Entity *e) {
-    zombieTree.insert(e);
+    insertUnit(e, CollisionCategory::ZOMBIE);
+}
+
+/*
+ * The per frame refresh of every marine and zombie takes the critical section once for the whole
+ * batch instead of once per entity. The grid splits the batch across threads inside it.
+ * Zombies come with the hitboxes and extents GameManager keeps for them, indexed by their slot,
+ * so empty slots are nullptr in the batch.
+ */
+void CollisionHandler::insertMarines(const std::vector<Entity *>& marines) {
+#pragma omp critical(collisionIndex)
+    unitGrid.insertBatch(marines, CollisionCategory::MARINE);
+}
+
+void CollisionHandler::insertZombies(const std::vector<Entity *>& zombies, const std::vector<HitBox>& boxes,
+        const std::vector<SDL_Rect>& extents) {
+#pragma omp critical(collisionIndex)
+    unitGrid.insertBatch(zombies, boxes, extents, CollisionCategory::ZOMBIE);
 }
 
 void CollisionHandler::insertBarricade(Entity *e) {
-    insertZombieMovementEntity(e);
-    barricadeTree.insert(e);
+    insertInto(placedTree, e, CollisionCategory::BARRICADE);
 }
 
 void CollisionHandler::insertTurret(Entity *e) {
-    insertZombieMovementEntity(e);
-    turretTree.insert(e);
+    insertInto(placedTree, e, CollisionCategory::TURRET);
 }
 
 void CollisionHandler::insertWall(Entity *e) {
-    insertZombieMovementEntity(e);
-    wallTree.insert(e);
+#pragma omp critical(collisionIndex)
+    wallBVH.add(e, CollisionCategory::WALL);
 }
 
 void CollisionHandler::insertPickUp(Entity *e) {
-    pickUpTree.insert(e);
+    insertInto(placedTree, e, CollisionCategory::PICKUP);
 }
 
 void CollisionHandler::insertObj(Entity *e) {
-    insertZombieMovementEntity(e);
-    objTree.insert(e);
+    insertInto(placedTree, e, CollisionCategory::OBJ);
 }
 
 void CollisionHandler::insertStore(Entity *e) {
-    insertZombieMovementEntity(e);
-    storeTree.insert(e);
+    insertInto(placedTree, e, CollisionCategory::STORE);
+}
+
+void CollisionHandler::removeMarine(const Entity *e) {
+    removeUnit(e, CollisionCategory::MARINE);
+}
+
+void CollisionHandler::removeZombie(const Entity *e) {
+    removeUnit(e, CollisionCategory::ZOMBIE);
+}
+
+void CollisionHandler::removeBarricade(const Entity *e) {
+    removeFrom(placedTree, e, CollisionCategory::BARRICADE);
+}
+
+void CollisionHandler::removeTurret(const Entity *e) {
+    removeFrom(placedTree, e, CollisionCategory::TURRET);
+}
+
+void CollisionHandler::removeWall(const Entity *e) {
+#pragma omp critical(collisionIndex)
+    wallBVH.remove(e, CollisionCategory::WALL);
+}
+
+/**
+ * Function Interface: void CollisionHandler::buildBroadphase(const int reach)
+ *      reach : Furthest a marine or zombie can move this frame, in pixels
+ *
+ * Description:
+ * Pairs up every marine and zombie whose movement hitboxes are within twice the reach of each other,
+ * so the movement checks this frame only look at the units paired with the one moving.
+ * Zombies walk through each other so they are never paired together.
+ * Has to run after the grid is refreshed so the pairs are built from the same hitboxes it holds.
+ */
+void CollisionHandler::buildBroadphase(const int reach) {
+#pragma omp critical(collisionIndex)
+    {
+        unitPairs.begin(reach);
+        unitGrid.visit(CollisionCategory::MARINE, [this](Entity *e) {
+            unitPairs.add(e, CollisionCategory::MARINE);
+            return false;
+        });
+        unitGrid.visit(CollisionCategory::ZOMBIE, [this](Entity *e) {
+            unitPairs.add(e, CollisionCategory::ZOMBIE);
+            return false;
+        });
+        unitPairs.build(CollisionCategory::ZOMBIE);
+    }
+}
+
+/**
+ * Function Interface: void CollisionHandler::buildStatic()
+ *
+ * Description:
+ * Builds the wall hierarchy. Only does work the first time it is called after walls change,
+ * so it is safe to call every frame.
+ */
+void CollisionHandler::buildStatic() {
+    wallBVH.build();
+}
+
+void CollisionHandler::removePickUp(const Entity *e) {
+    removeFrom(placedTree, e, CollisionCategory::PICKUP);
 }
 
-void CollisionHandler::insertZombieMovementEntity(Entity *e) {
-#pragma omp critical
-    zombieMovementTree.insert(e);
+void CollisionHandler::removeObj(const Entity *e) {
+    removeFrom(placedTree, e, CollisionCategory::OBJ);
+}
+
+void CollisionHandler::removeStore(const Entity *e) {
+    removeFrom(placedTree, e, CollisionCategory::STORE);
+}
+
+/**
+ * Function Interface: void insertInto(Index& index, Entity *e, const unsigned int category)
+ *      index : Layer to insert into
+ *      e : Entity to insert or move
+ *      category : CollisionCategory bits to add to its entry
+ *
+ * Description:
+ *      Entities are created and destroyed from inside omp tasks, so every change to a tree
+ *      goes through the same critical section.
+ */
+template<typename Index>
+void CollisionHandler::insertInto(Index& index, Entity *e, const unsigned int category) {
+#pragma omp critical(collisionIndex)
+    index.insert(e, category);
+}
+
+/**
+ * Function Interface: void removeFrom(Index& index, const Entity *e, const unsigned int category)
+ *      index : Layer to remove from
+ *      e : Entity to remove
+ *      category : CollisionCategory bits to take off its entry
+ *
+ * Description:
+ *      Removes a category from an entity inside the shared critical section.
+ */
+template<typename Index>
+void CollisionHandler::removeFrom(Index& index, const Entity *e, const unsigned int category) {
+#pragma omp critical(collisionIndex)
+    index.remove(e, category);
+}
+
+/**
+ * Function Interface: void insertUnit(Entity *e, const unsigned int category)
+ *      e : Marine or zombie to insert or move
+ *      category : CollisionCategory bits to add to its entry
+ *
+ * Description:
+ *      Inserts into the grid. A marine or zombie inserted between frames has no pairs of its own,
+ *      so its movement checks go back to the grid until the pairs are next built, while every paired
+ *      unit checks against it alongside its run.
+ */
+void CollisionHandler::insertUnit(Entity *e, const unsigned int category) {
+#pragma omp critical(collisionIndex)
+    {
+        unitGrid.insert(e, category);
+        unitPairs.addLate(e, category);
+    }
+}
+
+/**
+ * Function Interface: void removeUnit(const Entity *e, const unsigned int category)
+ *      e : Marine or zombie to remove
+ *      category : CollisionCategory bits to take off its entry
+ *
+ * Description:
+ *      Removes from the grid and drops the unit from every pair it is in.
+ */
+void CollisionHandler::removeUnit(const Entity *e, const unsigned int category) {
+#pragma omp critical(collisionIndex)
+    {
+        unitGrid.remove(e, category);
+        unitPairs.remove(e);
+    }
 }
@@ -14,6 +14,12 @@
 * Author:
 *
 * Notes:
+*       Everything is stored once, tagged with CollisionCategory bits, in whichever layer suits it:
+*       a grid for marines and zombies, a static hierarchy for walls and the base, and a loose
+*       quadtree for everything that gets placed. Queries take a category mask and only search
+*       the layers holding a category in the mask.
+*       Once the grid is refreshed each frame, buildBroadphase() pairs up every marine and zombie
+*       that could touch this frame, and movement checks against units read those pairs.
 *
 ------------------------------------------------------------------------------*/
 #ifndef COLLISION_H
@@ -21,39 +27,81 @@
 
 #include <vector>
 #include <queue>
+#include <utility>
 
 #include "HitBox.h"
+#include "Category.h"
+#include "Broadphase.h"
 #include "Quadtree.h"
+#include "SpatialGrid.h"
+#include "StaticBVH.h"
 #include "../inventory/weapons/Target.h"
+#include "../log/log.h"
 
 class Movable;
 
+//pixels of rounding allowed for where a shot hits before its distance is trusted
+static constexpr int LINE_HIT_MARGIN = 2;
+
 class CollisionHandler {
 public:
     CollisionHandler();
+    CollisionHandler(const SDL_Rect& mapBounds);
     ~CollisionHandler() = default;
 
+    // Resize every layer to cover the loaded map
+    void setMapBounds(const SDL_Rect& mapBounds);
+
     // Check for damage collisions, return object if hits
-    const HitBox *detectDamageCollision(std::vector<Entity*> returnObjects, const Entity *entity);
+    const Entity *detectDamageCollision(const std::vector<Entity*>& returnObjects, const Entity *entity);
 
     // Check for projectile collisions, return object if hits
-    const HitBox *detectProjectileCollision(std::vector<Entity*> returnObjects, const Entity *entity);
+    const Entity *detectProjectileCollision(const std::vector<Entity*>& returnObjects, const Entity *entity);
 
     //Check for collisions during movement
-    bool detectMovementCollision(const std::vector<Entity*> returnObjects, const Entity *entity);
+    bool detectMovementCollision(const std::vector<Entity*>& returnObjects, const Entity *entity);
 
     //check for pick up collision, return object if can pick up
-    Entity *detectPickUpCollision(std::vector<Entity*> returnObjects, const Entity *entity);
-
-    void detectLineCollision(TargetList& targetList, const int gunX, const int gunY, const double angle, const int range);
+    Entity *detectPickUpCollision(const std::vector<Entity*>& returnObjects, const Entity *entity);
+
+    // Same checks run straight against the index for the categories in the mask, stopping at the first hit
+    const Entity *detectDamageCollision(const unsigned int mask, const Entity *entity) const;
+    const Entity *detectProjectileCollision(const unsigned int mask, const Entity *entity) const;
+    bool detectMovementCollision(const unsigned int mask, const Entity *entity) const;
+    // Same movement check for a hitbox that isn't friendly and doesn't belong to anything yet
+    bool detectMovementCollision(const unsigned int mask, const SDL_Rect& box) const;
+    Entity *detectPickUpCollision(const unsigned int mask, const Entity *entity) const;
+
+    // Sweeps the movement hitbox by moveX then moveY against everything in the mask,
+    // stopping flush against whatever is in the way, and returns the position it reaches
+    std::pair<float, float> sweepMovement(const Entity *entity, const float moveX, const float moveY,
+        const unsigned int mask) const;
+    // Same sweep from a position and movement hitbox the caller keeps, the entity is only used to skip itself
+    std::pair<float, float> sweepMovement(const Entity *entity, const HitBox& box, const float x, const float y,
+        const float moveX, const float moveY, const unsigned int mask) const;
+
+    // Calls visitor with everything in the mask that could touch the rect, returning true stops the search
+    template<typename Visitor>
+    bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const;
+    void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect, const unsigned int mask) const;
+
+    void detectLineCollision(TargetList& targetList, const int gunX, const int gunY, const double angle, const int range,
+        const int penetration);
+    // Same as detectLineCollision for every pellet of a spread, with one search for the whole cone
+    void detectConeCollision(std::vector<TargetList>& targetLists, const int gunX, const int gunY, const double angle,
+        const double coneAngle, const int range);
 
     std::vector<Entity *> detectMeleeCollision(const std::vector<Entity*>& returnObjects, const Entity *entity, const HitBox hb);
 
     bool detectStoreCollision(const Entity* player, const Entity* store);
 
-    std::vector<Entity *>getQuadTreeEntities(const Quadtree& q, const Entity *entity) const; // General Collision handler, pass in quadtree check
+    std::vector<Entity *>getQuadTreeEntities(const unsigned int mask, const Entity *entity) const; // General Collision handler, pass in the categories to check
 
     void clear();
+    void buildStatic(); // Builds the wall layer if walls have been added or removed
+    void buildBroadphase(const int reach); // Pairs up marines and zombies within reach pixels of each other
+    void reserveUnits(const unsigned int n); // Inserting up to n marines and zombies in all won't allocate
+
     void insertMarine(Entity *e);
     void insertZombie(Entity *e);
     void insertBarricade(Entity *e);
@@ -62,33 +110,92 @@ public:
     void insertPickUp(Entity *e);
     void insertObj(Entity *e);
     void insertStore(Entity *e);
-
-    auto& getZombieMovementTree() {return zombieMovementTree;}
-    auto& getMarineTree() {return marineTree;}
-    auto& getZombieTree() {return zombieTree;}
-    auto& getBarricadeTree() {return barricadeTree;}
-    auto& getTurretTree() {return turretTree;}
-    auto& getWallTree() {return wallTree;}
-    auto& getPickUpTree() {return pickUpTree;}
-    auto& getObjTree() {return objTree;}
-    auto& getStoreTree() {return storeTree;}
+    // Same as inserting each one, refreshing most of them in parallel
+    void insertMarines(const std::vector<Entity *>& marines);
+    void insertZombies(const std::vector<Entity *>& zombies, const std::vector<HitBox>& boxes,
+        const std::vector<SDL_Rect>& extents);
+
+    void removeMarine(const Entity *e);
+    void removeZombie(const Entity *e);
+    void removeBarricade(const Entity *e);
+    void removeTurret(const Entity *e);
+    void removeWall(const Entity *e);
+    void removePickUp(const Entity *e);
+    void removeObj(const Entity *e);
+    void removeStore(const Entity *e);
 
 private:
-    void checkForTargetsInVector(const int gunX, const int gunY, const int endX, const int endY,
-        TargetList& targetList, const std::vector<Entity*>& allEntities, const int type) const;
-
-    void insertZombieMovementEntity(Entity *e);
-
-    Quadtree zombieMovementTree;
-    Quadtree marineTree; //can take dmg
-    Quadtree zombieTree; //can take dmg
-    Quadtree barricadeTree; //can take dmg
-    Quadtree turretTree;
-    Quadtree wallTree;
-    Quadtree pickUpTree;
-    Quadtree objTree;
-    Quadtree storeTree;
+    // Tests for a single pair of entities shared by the vector and index versions of the checks
+    static bool damageHit(const Entity *entity, const Entity *obj);
+    static bool projectileHit(const Entity *entity, const Entity *obj);
+    static bool movementHit(const Entity *entity, const Entity *obj);
+    static bool pickUpHit(const Entity *entity, const Entity *obj);
+
+    // Movement sweep helpers
+    static SDL_Rect sweptBox(const SDL_Rect& box, const float x, const float y, const float moveX,
+        const float moveY);
+    void gatherBlockers(const unsigned int mask, const SDL_Rect& swept, const Entity *entity, const bool friendly,
+        std::vector<SDL_Rect>& blockers) const;
+    static std::pair<float, float> resolveSweep(const SDL_Rect& box, const float x, const float y,
+        const float moveX, const float moveY, const std::vector<SDL_Rect>& blockers);
+    static float sweepAxis(const float from, const float delta, const float across, const int size,
+        const int acrossSize, const std::vector<SDL_Rect>& blockers, const bool horizontal);
+
+    static void lineEnd(const int gunX, const int gunY, const double angle, const int range, int& endX, int& endY);
+    static bool lineHit(const Entity *entity, const int gunX, const int gunY, const int endX, const int endY,
+        int& hitX, int& hitY, int& dist);
+
+    template<typename Index>
+    void insertInto(Index& index, Entity *e, const unsigned int category);
+    template<typename Index>
+    void removeFrom(Index& index, const Entity *e, const unsigned int category);
+    void insertUnit(Entity *e, const unsigned int category);
+    void removeUnit(const Entity *e, const unsigned int category);
+
+    SpatialGrid unitGrid; //marines and zombies
+    StaticBVH wallBVH; //walls and the base
+    Quadtree placedTree; //turrets, barricades, pickups, stores and objects
+    Broadphase unitPairs; //marines and zombies close enough to touch this frame
 };
 
+inline bool CollisionHandler::damageHit(const Entity *entity, const Entity *obj) {
+    return obj && entity != obj
+        && SDL_HasIntersection(&entity->getDamHitBox().getRect(), &obj->getDamHitBox().getRect())
+            && !(entity->getDamHitBox().isPlayerFriendly() && obj->getDamHitBox().isPlayerFriendly());
+}
+
+inline bool CollisionHandler::projectileHit(const Entity *entity, const Entity *obj) {
+    return obj && entity != obj
+        && SDL_HasIntersection(&entity->getProHitBox().getRect(), &obj->getProHitBox().getRect())
+            && !(entity->getProHitBox().isPlayerFriendly() && obj->getProHitBox().isPlayerFriendly());
+}
+
+inline bool CollisionHandler::movementHit(const Entity *entity, const Entity *obj) {
+    return obj && entity != obj
+        && SDL_HasIntersection(&entity->getMoveHitBox().getRect(), &obj->getMoveHitBox().getRect())
+            && !(entity->getMoveHitBox().isPlayerFriendly() && obj->getMoveHitBox().isPlayerFriendly());
+}
+
+inline bool CollisionHandler::pickUpHit(const Entity *entity, const Entity *obj) {
+    return obj && entity != obj
+        && SDL_HasIntersection(&entity->getMoveHitBox().getRect(), &obj->getPickUpHitBox().getRect())
+            && !(entity->getMoveHitBox().isPlayerFriendly() && obj->getPickUpHitBox().isPlayerFriendly());
+}
+
+/**
+ * Function Interface: bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const
+ *      rect : Area to search
+ *      mask : Categories to search
+ *      visitor : Called with everything in the mask that could touch the rect, returning true stops the search
+ *
+ * Description:
+ * Searches each layer holding a category in the mask. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool CollisionHandler::visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const {
+    return ((mask & CollisionCategory::UNITS) && unitGrid.visit(rect, mask, visitor))
+        || ((mask & CollisionCategory::STATIC) && wallBVH.visit(rect, mask, visitor))
+        || ((mask & CollisionCategory::PLACED) && placedTree.visit(rect, mask, visitor));
+}
 
 #endif
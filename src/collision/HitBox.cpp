@@ -18,32 +18,6 @@
 ------------------------------------------------------------------------------*/
 #include "HitBox.h"
 
-/**
- * Date: Feb. 4, 2017
- * Modified: ----
- * Author: Jacob McPhail
- * Function Interface: HitBox(SDL_Rect nrect)
- *      nrect : Hit box rect
- *
- * Description:
- *      ctor for a hitbox     
- */
-HitBox::HitBox(SDL_Rect nrect) : rect(nrect) {
-
-}
-
-/**
- * Date: Feb. 4, 2017
- * Modified: ----
- * Author: Jacob McPhail
- * Function Interface: getRect()
- * Description:
- *     Getter for the hit box rect.
- */
-const SDL_Rect& HitBox::getRect() const {
-    return rect;
-}
-
 /**
  * Date: Feb. 4, 2017
  * Modified: ----
@@ -88,18 +62,6 @@ void HitBox::setFriendly(const bool isFriendly) {
     playerFriendly = isFriendly;
 }
 
-/**
- * Date: Feb. 4, 2017
- * Modified: ----
- * Author: Jacob McPhail
- * Function Interface: isPlayerFriendly()
- * Description:
- *     Check if hitbox is friendly.
- */
-bool HitBox::isPlayerFriendly() const {
-    return playerFriendly;
-}
-
 bool operator!=(const HitBox& first, const HitBox& second) {
     return first.rect != second.rect && first.playerFriendly != second.playerFriendly;
 }
@@ -14,23 +14,34 @@
 * Author:
 *
 * Notes:
+*       Entities only store a HitBoxExtent for each of their hitboxes, the HitBox itself is
+*       built from the entity's position whenever it is asked for.
 *
 ------------------------------------------------------------------------------*/
 #ifndef HITBOX_H
 #define HITBOX_H
 #include <SDL2/SDL.h>
+#include <cstdint>
+
+//where a hitbox sits relative to the top left corner of its entity, and its size
+struct HitBoxExtent {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+};
 
 class HitBox {
 public:
-    HitBox(SDL_Rect nrect);
+    HitBox(SDL_Rect nrect, const bool friendly = false) : rect(nrect), playerFriendly(friendly) {}
     ~HitBox() = default;
 
     void move(const float x, const float y);
     void setRect(const SDL_Rect& rect);
-    const SDL_Rect& getRect() const;
+    const SDL_Rect& getRect() const {return rect;}
 
     void setFriendly(const bool isFriendly);
-    bool isPlayerFriendly() const;
+    bool isPlayerFriendly() const {return playerFriendly;}
 
 
     friend bool operator!=(const HitBox& first, const HitBox& second);
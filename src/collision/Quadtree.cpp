@@ -17,8 +17,6 @@
 *
 ------------------------------------------------------------------------------*/
 #include <SDL2/SDL.h>
-#include <array>
-#include <memory>
 #include <algorithm>
 #include "Quadtree.h"
 #include "../basic/Entity.h"
@@ -26,38 +24,60 @@
 
 /**
  * Date: April. 9, 2017
- * Modified: -----
  * Author: John Agapeyev
- * Function Interface: (unsigned int pLevel, SDL_Rect pBounds)
- *      pLevel : Levels of the quad tree
+ * Function Interface: Quadtree(const SDL_Rect& pBounds, unsigned int pLevels)
  *      pBounds : Bounds of the quadtree area
+ *      pLevels : Number of times the area is subdivided
  *
  * Description:
  *      ctor for a quadtree.
  */
-Quadtree::Quadtree(unsigned int pLevel, SDL_Rect pBounds) : level(pLevel), bounds(pBounds) {
-    if (level == MAX_LEVELS) {
-        return;
+Quadtree::Quadtree(const SDL_Rect& pBounds, unsigned int pLevels) {
+    reset(pBounds, pLevels);
+}
+
+/**
+ * Function Interface: reset(const SDL_Rect& pBounds, unsigned int pLevels)
+ *      pBounds : Bounds of the quadtree area
+ *      pLevels : Number of times the area is subdivided
+ *
+ * Description:
+ *      Rebuilds the node pool for a new area, removing every object in the tree.
+ */
+void Quadtree::reset(const SDL_Rect& pBounds, unsigned int pLevels) {
+    levels = std::min(pLevels, MAX_LEVELS);
+    leafStart = levels ? nodeCount(levels - 1) : 0;
+    locations.clear();
+
+    nodes.clear();
+    nodes.resize(nodeCount(levels));
+    nodes[0].bounds = pBounds;
+
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+        const SDL_Rect& b = nodes[i].bounds;
+        nodes[i].looseBounds = {b.x - b.w / 2, b.y - b.h / 2, b.w * LOOSENESS, b.h * LOOSENESS};
+        if (i >= leafStart) {
+            continue;
+        }
+        const unsigned int child = firstChild(i);
+        const int halfW = b.w / 2;
+        const int halfH = b.h / 2;
+        nodes[child].bounds = {b.x, b.y, halfW, halfH};
+        nodes[child + 1].bounds = {b.x + halfW, b.y, b.w - halfW, halfH};
+        nodes[child + 2].bounds = {b.x, b.y + halfH, halfW, b.h - halfH};
+        nodes[child + 3].bounds = {b.x + halfW, b.y + halfH, b.w - halfW, b.h - halfH};
     }
-    nodes[0] = std::make_unique<Quadtree>(level + 1, SDL_Rect{bounds.x, bounds.y, bounds.w / 2, bounds.h / 2});
-    nodes[1] = std::make_unique<Quadtree>(level + 1, SDL_Rect{bounds.x + bounds.w / 2, bounds.y, bounds.w / 2, 
-            bounds.h / 2});
-    nodes[2] = std::make_unique<Quadtree>(level + 1, SDL_Rect{bounds.x, bounds.y + bounds.h / 2, bounds.w / 2, 
-            bounds.h / 2});
-    nodes[3] = std::make_unique<Quadtree>(level + 1, SDL_Rect{bounds.x + bounds.w / 2, bounds.y + bounds.h / 2, 
-            bounds.w / 2, bounds.h / 2});
 }
 
 /**
  * Date: Feb. 8, 2017
- * Modified: -----
  * Author: Jacob McPhail
  * Function Interface: getTreeSize()
  * Description:
  *      Get the number of objects in the tree.
  */
 unsigned int Quadtree::getTreeSize() const {
-    return objects.size();
+    return locations.size();
 }
 
 /**
@@ -65,196 +85,237 @@ unsigned int Quadtree::getTreeSize() const {
  * Author: John Agapeyev
  * Function Interface: clear()
  * Description:
- *      Clears all objects in the tree.
+ *      Clears all objects in the tree, keeping their storage so refilling it doesn't allocate.
  */
 void Quadtree::clear() {
-    if (level == MAX_LEVELS) { 
-        objects.clear();
-        return;
-    }
-    if (nodes[0]) {
-        nodes[0]->clear();
-    }
-    if (nodes[1]) {
-        nodes[1]->clear();
+    for (auto& node : nodes) {
+        node.objects.clear();
+        node.categories.clear();
     }
-    if (nodes[2]) {
-        nodes[2]->clear();
+    locations.clear();
+}
+
+/**
+ * Function Interface: levelsFor(const SDL_Rect& pBounds, const int minNodeSize)
+ *      pBounds : Area the tree will cover
+ *      minNodeSize : Smallest width a leaf is allowed to have
+ *
+ * Description:
+ *      Calculates how many times an area can be subdivided before its leaves become
+ *      smaller than minNodeSize.
+ */
+unsigned int Quadtree::levelsFor(const SDL_Rect& pBounds, const int minNodeSize) {
+    unsigned int result = 0;
+    for (int width = std::max(pBounds.w, pBounds.h); result < MAX_LEVELS && width / 2 >= minNodeSize; width /= 2) {
+        ++result;
     }
-    if (nodes[3]) {
-        nodes[3]->clear();
+    return result;
+}
+
+/**
+ * Function Interface: getExtent(const Entity *entity)
+ *      entity : Entity to measure
+ *
+ * Description:
+ *      Returns the smallest rect holding the entity's sprite and all of its hitboxes.
+ */
+SDL_Rect Quadtree::getExtent(const Entity *entity) {
+    const SDL_Rect rects[] = {entity->getDestRect(), entity->getMoveHitBox().getRect(),
+        entity->getProHitBox().getRect(), entity->getDamHitBox().getRect(),
+        entity->getPickUpHitBox().getRect()};
+
+    int left = rects[0].x;
+    int top = rects[0].y;
+    int right = rects[0].x + rects[0].w;
+    int bottom = rects[0].y + rects[0].h;
+    for (const SDL_Rect& r : rects) {
+        left = std::min(left, r.x);
+        top = std::min(top, r.y);
+        right = std::max(right, r.x + r.w);
+        bottom = std::max(bottom, r.y + r.h);
     }
-    objects.clear();
+    return {left, top, right - left, bottom - top};
 }
 
 /**
- * Date: April. 9, 2017
- * Designer: Isaac Morneau
- * Programmer: John Agapeyev
- * Function Interface: bool contains(const Quadtree& q, const Entity *entity) const
+ * Function Interface: findNode(const SDL_Rect& extent) const
+ *      extent : Area the object covers
+ *
  * Description:
- *      Checks if a given entity exists in the given quadtree
+ *      Walks down from the root following the quadrant holding the centre of the extent,
+ *      stopping at the last node that is still at least as big as the extent.
+ *      Anything centred outside the tree is kept in the root.
  */
-bool Quadtree::contains(const Quadtree& q, const Entity *entity) const {
-    if (q.level == MAX_LEVELS) {
-        return (entity && rectContains(q.bounds, entity->getDestRect()));
+unsigned int Quadtree::findNode(const SDL_Rect& extent) const {
+    const int centreX = extent.x + extent.w / 2;
+    const int centreY = extent.y + extent.h / 2;
+    const SDL_Rect& root = nodes.front().bounds;
+
+    if (centreX < root.x || centreX >= root.x + root.w || centreY < root.y || centreY >= root.y + root.h) {
+        return 0;
+    }
+
+    unsigned int node = 0;
+    while (node < leafStart) {
+        const SDL_Rect& b = nodes[node].bounds;
+        unsigned int child = firstChild(node);
+        if (centreX >= b.x + b.w / 2) {
+            child += 1;
+        }
+        if (centreY >= b.y + b.h / 2) {
+            child += 2;
+        }
+        if (extent.w > nodes[child].bounds.w || extent.h > nodes[child].bounds.h) {
+            break;
+        }
+        node = child;
     }
-    return ((entity && rectContains(q.bounds, entity->getDestRect()))
-            || (q.nodes[0] && contains(*q.nodes[0], entity)) 
-            || (q.nodes[3] && contains(*q.nodes[3], entity))
-            || (q.nodes[1] && contains(*q.nodes[1], entity))
-            || (q.nodes[2] && contains(*q.nodes[2], entity)));
+    return node;
 }
 
 /**
  * Date: April. 9, 2017
  * Author: John Agapeyev
- * Function Interface: insert(Entity *entity)
+ * Function Interface: bool insert(Entity *entity, const unsigned int category)
  *      entity : Hitbox to insert
+ *      category : CollisionCategory bits to add to its entry
  *
  * Description:
- *      Insert a hitbox into the quadtree.
+ *      Insert a hitbox into the quadtree, or move it if it has left its node. An entity already
+ *      in the tree keeps the categories it had along with the new ones.
+ *      Returns true if the entity was added or moved.
  */
-void Quadtree::insert(Entity *entity) {
-    if (level == MAX_LEVELS) {
-        objects.push_back(entity);
-        return;
-    }
-    if (nodes[0] && contains(*nodes[0], entity)) {
-        nodes[0]->insert(entity);
-        return;
+bool Quadtree::insert(Entity *entity, const unsigned int category) {
+    if (!entity) {
+        return false;
     }
-    if (nodes[3] && contains(*nodes[3], entity)) {
-        nodes[3]->insert(entity);
-        return;
+    const unsigned int node = findNode(getExtent(entity));
+    unsigned int bits = category;
+    const auto it = locations.find(entity);
+    if (it != locations.end()) {
+        Node& current = nodes[it->second];
+        const unsigned int index = findInNode(it->second, entity);
+        bits |= current.categories[index];
+        if (it->second == node) {
+            current.categories[index] = bits;
+            return false;
+        }
+        removeFromNode(it->second, index);
+        it->second = node;
+    } else {
+        locations.emplace(entity, node);
     }
-    if (nodes[1] && contains(*nodes[1], entity)) {
-        nodes[1]->insert(entity);
+    nodes[node].objects.push_back(entity);
+    nodes[node].categories.push_back(bits);
+    return true;
+}
+
+/**
+ * Function Interface: void remove(const Entity *entity, const unsigned int category)
+ *      entity : Hitbox to remove
+ *      category : CollisionCategory bits to take off its entry
+ *
+ * Description:
+ *      Takes category bits off a hitbox, removing it from the quadtree once it has none left.
+ *      Does nothing if it isn't in the tree.
+ */
+void Quadtree::remove(const Entity *entity, const unsigned int category) {
+    const auto it = locations.find(entity);
+    if (it == locations.end()) {
         return;
     }
-    if (nodes[2] && contains(*nodes[2], entity)) {
-        nodes[2]->insert(entity);
+    const unsigned int index = findInNode(it->second, entity);
+    auto& bits = nodes[it->second].categories[index];
+    bits &= ~category;
+    if (bits) {
         return;
     }
-    objects.push_back(entity);
+    removeFromNode(it->second, index);
+    locations.erase(it);
+}
+
+/**
+ * Function Interface: unsigned int findInNode(const unsigned int node, const Entity *entity) const
+ *      node : Index of the node holding the entity
+ *      entity : Hitbox to find
+ *
+ * Description:
+ *      Returns where the entity sits in the node's list. The entity must be in the node.
+ */
+unsigned int Quadtree::findInNode(const unsigned int node, const Entity *entity) const {
+    const auto& objects = nodes[node].objects;
+    return std::find(objects.begin(), objects.end(), entity) - objects.begin();
+}
+
+/**
+ * Function Interface: void removeFromNode(const unsigned int node, const unsigned int index)
+ *      node : Index of the node holding the entity
+ *      index : Where the entity sits in the node's list
+ *
+ * Description:
+ *      Swaps the entity to the back of the node's list and pops it.
+ */
+void Quadtree::removeFromNode(const unsigned int node, const unsigned int index) {
+    auto& objects = nodes[node].objects;
+    auto& categories = nodes[node].categories;
+    objects[index] = objects.back();
+    objects.pop_back();
+    categories[index] = categories.back();
+    categories.pop_back();
 }
 
 /**
  * Date: April. 9, 2017
  * Modified: -----
  * Author: John Agapeyev
- * Function Interface: retrieve(const Entity *entity)
+ * Function Interface: retrieve(const Entity *entity, const unsigned int mask)
  *      entity : Entity to check collisions
+ *      mask : Categories to retrieve
  *
  * Description:
- *      Retrieve a vector of hitboxes that are near the param hitbox.      
+ *      Retrieve a vector of hitboxes in the mask that are near the param hitbox.
  */
-std::vector<Entity *> Quadtree::retrieve(const Entity *entity) const {
+std::vector<Entity *> Quadtree::retrieve(const Entity *entity, const unsigned int mask) const {
     if (!entity) {
         return {};
     }
     std::vector<Entity *> retrieved;
     retrieved.reserve(100);
-    retrieve(retrieved, entity->getDestRect());
+    retrieve(retrieved, getExtent(entity), mask);
     return retrieved;
 }
 
-void Quadtree::retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect) const {
-    if (level == MAX_LEVELS) {
-        retrieveList.insert(retrieveList.end(), objects.begin(), objects.end());
-        return;
-    }
-    if (!objects.empty()) {
-        retrieveList.insert(retrieveList.end(), objects.begin(), objects.end());
-    }
-    if (nodes[0] && SDL_HasIntersection(&nodes[0]->bounds, &rect)) {
-        nodes[0]->retrieve(retrieveList, rect);
-    }
-    if (nodes[3] && SDL_HasIntersection(&nodes[3]->bounds, &rect)) {
-        nodes[3]->retrieve(retrieveList, rect);
-    }
-    if (nodes[1] && SDL_HasIntersection(&nodes[1]->bounds, &rect)) {
-        nodes[1]->retrieve(retrieveList, rect);
-    }
-    if (nodes[2] && SDL_HasIntersection(&nodes[2]->bounds, &rect)) {
-        nodes[2]->retrieve(retrieveList, rect);
-    }
-}
-
-std::vector<Entity *> Quadtree::retrieve(const Point& start, const Point& end) const {
-    if (level == MAX_LEVELS) {
-        return objects;
-    }
-    std::vector<Entity *> rtn;
-    if (!objects.empty()) {
-        rtn = objects;
-    }
-    if (nodes[0] && lineRectIntersect({start, end}, nodes[0]->bounds)) {
-        const auto& childrtn = nodes[0]->retrieve(start, end);
-        rtn.insert(rtn.end(), childrtn.begin(), childrtn.end());
-    }
-    if (nodes[3] && lineRectIntersect({start, end}, nodes[3]->bounds)) {
-        const auto& childrtn = nodes[3]->retrieve(start, end);
-        rtn.insert(rtn.end(), childrtn.begin(), childrtn.end());
-    }
-    if (nodes[1] && lineRectIntersect({start, end}, nodes[1]->bounds)) {
-        const auto& childrtn = nodes[1]->retrieve(start, end);
-        rtn.insert(rtn.end(), childrtn.begin(), childrtn.end());
-    }
-    if (nodes[2] && lineRectIntersect({start, end}, nodes[2]->bounds)) {
-        const auto& childrtn = nodes[2]->retrieve(start, end);
-        rtn.insert(rtn.end(), childrtn.begin(), childrtn.end());
-    }
-    if (level == 0) {
-        std::sort(rtn.begin(), rtn.end());
-        rtn.erase(std::unique(rtn.begin(), rtn.end()), rtn.end());
-    }
-    return rtn;
-}
-
 /**
- * https://stackoverflow.com/questions/4977491/determining-if-two-line-segments-intersect/4977569#4977569
+ * Function Interface: retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+ *          const unsigned int mask) const
+ *      retrieveList : List the found entities are appended to
+ *      rect : Area to search
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Appends every object in the mask stored in a node whose loose bounds touch the rect.
  */
-inline bool constexpr Quadtree::lineIntersect(const std::pair<Point, Point>& start, const std::pair<Point, Point>& end) {
-    const float x00 = start.first.first;
-    const float y00 = start.first.second;
-    const float x10 = start.second.first;
-    const float y10 = start.second.second;
-
-    const float x01 = end.first.first;
-    const float y01 = end.first.second;
-    const float x11 = end.second.first;
-    const float y11 = end.second.second;
-
-    const float d = (x11 * y01) - (x01 * y11);
-
-    if (!d) {
+void Quadtree::retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect, const unsigned int mask) const {
+    visit(rect, mask, [&retrieveList](Entity *e) {
+        retrieveList.push_back(e);
         return false;
-    }
-
-    const float s = (1 / d) *  ((x00 - x10) * y01 - (y00 - y10) * x01);
-    const float t = (1 / d) * -(-(x00 - x10) * y11 + (y00 - y10) * x11);
-
-    return (s >= 0 && s <= 1) && (t >=0 && t <= 1);
-}
-
-inline bool constexpr Quadtree::pointInRect(const Point& point, const SDL_Rect& rect) {
-    return (rect.x <= point.first) && (point.first <= rect.x + rect.w) 
-        && (rect.y <= point.second) && (point.second <= rect.y + rect.h);
-}
-
-inline bool constexpr Quadtree::rectContains(const SDL_Rect& outer, const SDL_Rect& inner) {
-    return pointInRect({inner.x, inner.y}, outer) && pointInRect({inner.x + inner.w, inner.y + inner.h}, outer);
+    });
 }
 
 /**
- * Checks if the line intersects any of the 4 boundaries of the rectangle
- * If it doesn't intersect, checks if the line lies entirely inside the rectangle
+ * Function Interface: retrieve(const Point& start, const Point& end, const unsigned int mask) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Retrieves every object in the mask stored in a node the line passes through.
  */
-inline bool constexpr Quadtree::lineRectIntersect(const std::pair<Point, Point>& line, const SDL_Rect& rect) {
-    return lineIntersect(line, {{rect.x, rect.y}, {rect.x + rect.w, rect.y}}) //Top
-            && lineIntersect(line, {{rect.x, rect.y}, {rect.x, rect.y + rect.h}}) //Left
-            && lineIntersect(line, {{rect.x + rect.w, rect.y}, {rect.x + rect.w, rect.y + rect.h}}) //Right
-            && lineIntersect(line, {{rect.x, rect.y + rect.h}, {rect.x + rect.w, rect.y + rect.h}}) //Bottom
-            && pointInRect(line.first, rect) && pointInRect(line.second, rect);
+std::vector<Entity *> Quadtree::retrieve(const Point& start, const Point& end, const unsigned int mask) const {
+    std::vector<Entity *> rtn;
+    visit(start, end, mask, [&rtn](Entity *e) {
+        rtn.push_back(e);
+        return false;
+    });
+    return rtn;
 }
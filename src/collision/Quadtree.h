@@ -14,6 +14,17 @@
 * Author:
 *
 * Notes:
+*       The tree is a loose quadtree. Every node owns a tight quadrant of its parent
+*       and a loose area twice that size centred on it, so an entity is stored exactly once
+*       in the deepest node whose quadrant is at least as large as the entity.
+*       All nodes live in a single vector laid out like a heap, the children of node i
+*       are at 4i + 1 to 4i + 4.
+*       Entries persist between frames. Inserting an entity that is already in the tree
+*       only moves it if it now belongs to a different node.
+*       visit() calls a functor with each candidate and stops as soon as it returns true,
+*       the retrieve functions are wrappers that collect every candidate into a vector.
+*       Every entry carries CollisionCategory bits next to it in its node, so one tree can
+*       hold several kinds of entity and each query only sees the categories in its mask.
 *
 ------------------------------------------------------------------------------*/
 #ifndef QUADTREE_H
@@ -21,41 +32,168 @@
 #include <SDL2/SDL.h>
 #include <vector>
 #include <array>
-#include <memory>
 #include <utility>
+#include <unordered_map>
 
 #include "HitBox.h"
+#include "Category.h"
 #include "../basic/Entity.h"
 #include "../buildings/Base.h"
 
 static constexpr unsigned int BRANCHSIZE = 4;
-static constexpr unsigned int MAX_LEVELS = 3;
+//a node's loose bounds are this many times the size of its tight bounds
+static constexpr int LOOSENESS = 2;
+//hard cap on the depth so the node pool stays small
+static constexpr unsigned int MAX_LEVELS = 7;
 
 class Quadtree {
 public:
-    Quadtree(unsigned int pLevel, SDL_Rect pBounds);
+    Quadtree(const SDL_Rect& pBounds, unsigned int pLevels);
     ~Quadtree() = default;
 
+    void reset(const SDL_Rect& pBounds, unsigned int pLevels);
     void clear();
     unsigned int getTreeSize() const;
-    void insert(Entity *entity);
-    std::vector<Entity *> retrieve(const Entity *entity) const;
-    void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect) const;
-    std::vector<Entity *> retrieve(const Point& start, const Point& end) const;
+    bool insert(Entity *entity, const unsigned int category);
+    void remove(const Entity *entity, const unsigned int category = CollisionCategory::ALL);
+    bool contains(const Entity *entity) const {return locations.count(entity);}
+    std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask = CollisionCategory::ALL) const;
+    void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+        const unsigned int mask = CollisionCategory::ALL) const;
+    std::vector<Entity *> retrieve(const Point& start, const Point& end,
+        const unsigned int mask = CollisionCategory::ALL) const;
+
+    template<typename Visitor>
+    bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const;
+    template<typename Visitor>
+    bool visit(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor) const;
+
+    const SDL_Rect& getBounds() const {return nodes.front().bounds;}
+    unsigned int getLevels() const {return levels;}
+
+    static unsigned int levelsFor(const SDL_Rect& pBounds, const int minNodeSize);
+    static SDL_Rect getExtent(const Entity *entity);
 
 private:
-    bool contains(const Quadtree& q, const Entity *entity) const;
-    std::vector<Entity *> retrieve(const SDL_Rect& rect) const;
-
-    static inline bool constexpr lineIntersect(const std::pair<Point, Point>& start, const std::pair<Point, Point>& end);
-    static inline bool constexpr lineRectIntersect(const std::pair<Point, Point>& line, const SDL_Rect& rect);
-    static inline bool constexpr pointInRect(const Point& point, const SDL_Rect& rect);
-    static inline bool constexpr rectContains(const SDL_Rect& outer, const SDL_Rect& inner);
-
-    unsigned int level;
-    SDL_Rect bounds;
-    std::array<std::unique_ptr<Quadtree>, BRANCHSIZE> nodes;
-    std::vector<Entity *> objects;
+    struct Node {
+        SDL_Rect bounds;
+        SDL_Rect looseBounds;
+        std::vector<Entity *> objects;
+        //CollisionCategory bits of each object
+        std::vector<unsigned int> categories;
+    };
+
+    unsigned int findNode(const SDL_Rect& extent) const;
+    unsigned int findInNode(const unsigned int node, const Entity *entity) const;
+    void removeFromNode(const unsigned int node, const unsigned int index);
+    template<typename Visitor>
+    static bool visitNode(const Node& n, const unsigned int mask, Visitor&& visitor);
+
+    static constexpr unsigned int firstChild(const unsigned int node) {return node * BRANCHSIZE + 1;}
+    static constexpr unsigned int nodeCount(const unsigned int pLevels) {
+        return pLevels ? BRANCHSIZE * nodeCount(pLevels - 1) + 1 : 1;
+    }
+
+    unsigned int levels;
+    unsigned int leafStart;
+    std::vector<Node> nodes;
+    //node each stored entity currently lives in
+    std::unordered_map<const Entity *, unsigned int> locations;
 };
 
+/**
+ * Function Interface: bool visitNode(const Node& n, const unsigned int mask, Visitor&& visitor)
+ *      n : Node to search
+ *      mask : Categories to search
+ *      visitor : Called with every object in the node sharing a category with the mask
+ *
+ * Description:
+ *      Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool Quadtree::visitNode(const Node& n, const unsigned int mask, Visitor&& visitor) {
+    for (unsigned int i = 0; i < n.objects.size(); ++i) {
+        if ((n.categories[i] & mask) && visitor(n.objects[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const
+ *      rect : Area to search
+ *      mask : Categories to search
+ *      visitor : Called with every object in the mask in a node whose loose bounds touch the rect,
+ *                returning true stops the search
+ *
+ * Description:
+ *      Walks the tree without allocating. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool Quadtree::visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const {
+    std::array<unsigned int, BRANCHSIZE * MAX_LEVELS + 1> stack;
+    unsigned int top = 0;
+    stack[top++] = 0;
+
+    while (top) {
+        const unsigned int node = stack[--top];
+        const Node& n = nodes[node];
+        //the root also holds everything that fell outside the tree, so it is always searched
+        if (node && !SDL_HasIntersection(&n.looseBounds, &rect)) {
+            continue;
+        }
+        if (visitNode(n, mask, visitor)) {
+            return true;
+        }
+        if (node < leafStart) {
+            for (unsigned int i = 0; i < BRANCHSIZE; ++i) {
+                stack[top++] = firstChild(node) + i;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visit(const Point& start, const Point& end, const unsigned int mask,
+ *          Visitor&& visitor) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to search
+ *      visitor : Called with every object in the mask in a node the line passes through,
+ *                returning true stops the search
+ *
+ * Description:
+ *      Walks the tree along a line without allocating. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool Quadtree::visit(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor) const {
+    std::array<unsigned int, BRANCHSIZE * MAX_LEVELS + 1> stack;
+    unsigned int top = 0;
+    stack[top++] = 0;
+
+    while (top) {
+        const unsigned int node = stack[--top];
+        const Node& n = nodes[node];
+        //SDL clips the line in place so it needs its own copy each time
+        int x1 = start.first;
+        int y1 = start.second;
+        int x2 = end.first;
+        int y2 = end.second;
+        if (node && !SDL_IntersectRectAndLine(&n.looseBounds, &x1, &y1, &x2, &y2)) {
+            continue;
+        }
+        if (visitNode(n, mask, visitor)) {
+            return true;
+        }
+        if (node < leafStart) {
+            for (unsigned int i = 0; i < BRANCHSIZE; ++i) {
+                stack[top++] = firstChild(node) + i;
+            }
+        }
+    }
+    return false;
+}
+
 #endif
@@ -0,0 +1,350 @@
+/*------------------------------------------------------------------------------
+* Header: SpatialGrid.cpp
+*
+* Functions:
+*       SpatialGrid(const SDL_Rect& pBounds, const int pCellSize)
+*       void reset(const SDL_Rect& pBounds, const int pCellSize)
+*       void clear()
+*       bool insert(Entity *entity, const unsigned int category)
+*       void insertBatch(const std::vector<Entity *>& batch, const unsigned int category)
+*       void insertBatch(const std::vector<Entity *>& batch, const std::vector<HitBox>& boxes,
+*           const std::vector<SDL_Rect>& extents, const unsigned int category)
+*       void remove(const Entity *entity, const unsigned int category)
+*       std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask) const
+*       void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect, const unsigned int mask) const
+*       std::vector<Entity *> retrieve(const Point& start, const Point& end, const unsigned int mask) const
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*
+------------------------------------------------------------------------------*/
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <omp.h>
+#include "SpatialGrid.h"
+#include "Quadtree.h"
+
+/**
+ * Function Interface: SpatialGrid(const SDL_Rect& pBounds, const int pCellSize)
+ *      pBounds : Area covered by the grid
+ *      pCellSize : Width and height of each cell
+ *
+ * Description:
+ *      ctor for a spatial grid.
+ */
+SpatialGrid::SpatialGrid(const SDL_Rect& pBounds, const int pCellSize) {
+    reset(pBounds, pCellSize);
+}
+
+/**
+ * Function Interface: void reset(const SDL_Rect& pBounds, const int pCellSize)
+ *      pBounds : Area covered by the grid
+ *      pCellSize : Width and height of each cell
+ *
+ * Description:
+ *      Resizes the grid, removing everything in it.
+ */
+void SpatialGrid::reset(const SDL_Rect& pBounds, const int pCellSize) {
+    bounds = pBounds;
+    cellSize = std::max(pCellSize, 1);
+    cols = std::max((bounds.w + cellSize - 1) / cellSize, 1);
+    rows = std::max((bounds.h + cellSize - 1) / cellSize, 1);
+
+    cells.clear();
+    cells.resize(cols * rows);
+    locations.clear();
+    maxWidth = 0;
+    maxHeight = 0;
+}
+
+/**
+ * Function Interface: void clear()
+ *
+ * Description:
+ *      Removes everything from the grid, keeping the storage of each cell.
+ */
+void SpatialGrid::clear() {
+    for (auto& cell : cells) {
+        cell.clear();
+    }
+    locations.clear();
+    maxWidth = 0;
+    maxHeight = 0;
+}
+
+/**
+ * Function Interface: int cellX(const int x) const
+ *      x : Horizontal position in pixels
+ *
+ * Description:
+ *      Returns the column holding x, clamped to the grid.
+ */
+int SpatialGrid::cellX(const int x) const {
+    if (x < bounds.x) {
+        return 0;
+    }
+    return std::min((x - bounds.x) / cellSize, cols - 1);
+}
+
+/**
+ * Function Interface: int cellY(const int y) const
+ *      y : Vertical position in pixels
+ *
+ * Description:
+ *      Returns the row holding y, clamped to the grid.
+ */
+int SpatialGrid::cellY(const int y) const {
+    if (y < bounds.y) {
+        return 0;
+    }
+    return std::min((y - bounds.y) / cellSize, rows - 1);
+}
+
+/**
+ * Function Interface: unsigned int cellOf(const SDL_Rect& extent) const
+ *      extent : Area covered by an entity
+ *
+ * Description:
+ *      Returns the index of the cell holding the top left corner of the extent.
+ */
+unsigned int SpatialGrid::cellOf(const SDL_Rect& extent) const {
+    return cellY(extent.y) * cols + cellX(extent.x);
+}
+
+/**
+ * Function Interface: bool insert(Entity *entity, const unsigned int category)
+ *      entity : Entity to insert
+ *      category : CollisionCategory bits to add to its entry
+ *
+ * Description:
+ *      Adds an entity to the grid, or moves it if it is already in the grid and has changed cells.
+ *      The stored copy of its movement hitbox is refreshed and the category bits added either way.
+ *      Returns true if the entity was added or moved.
+ */
+bool SpatialGrid::insert(Entity *entity, const unsigned int category) {
+    if (!entity) {
+        return false;
+    }
+    const SDL_Rect extent = Quadtree::getExtent(entity);
+    maxWidth = std::max(maxWidth, extent.w);
+    maxHeight = std::max(maxHeight, extent.h);
+    return place(entity, cellOf(extent), category);
+}
+
+/**
+ * Function Interface: bool place(Entity *entity, const unsigned int cell, const unsigned int category)
+ *      entity : Entity to insert
+ *      cell : Cell the entity belongs in
+ *      category : CollisionCategory bits to add to its entry
+ *
+ * Description:
+ *      Does the work of insert() once the cell is known. Returns true if the entity was added or moved.
+ */
+bool SpatialGrid::place(Entity *entity, const unsigned int cell, const unsigned int category) {
+    unsigned int bits = category;
+    Location *loc = locations.get(entity);
+    if (loc) {
+        BoxSet& current = cells[loc->cell];
+        bits |= current.getCategory(loc->index);
+        if (loc->cell == cell) {
+            current.setCategory(loc->index, bits);
+            current.set(loc->index);
+            return false;
+        }
+        removeFromCell(*loc);
+        *loc = {cell, cells[cell].size()};
+    } else {
+        locations.insert(entity, Location{cell, cells[cell].size()});
+    }
+    cells[cell].push(entity, bits);
+    return true;
+}
+
+/**
+ * Function Interface: void insertBatch(const std::vector<Entity *>& batch, const unsigned int category)
+ *      batch : Entities to insert or refresh
+ *      category : CollisionCategory bits to add to each of their entries
+ *
+ * Description:
+ *      Does the same as calling insert() on every entity in the batch. The batch is split across
+ *      threads, each refreshing the stored hitbox of every entity that is still in its cell and
+ *      already has the category, and staging the rest in its own list. Only the staged entities
+ *      are then added or moved, one at a time, so nothing is written by two threads at once.
+ *      The batch must not hold the same entity twice.
+ */
+void SpatialGrid::insertBatch(const std::vector<Entity *>& batch, const unsigned int category) {
+    refreshBatch(batch, nullptr, nullptr, category);
+}
+
+/**
+ * Function Interface: void insertBatch(const std::vector<Entity *>& batch, const std::vector<HitBox>& boxes,
+ *          const std::vector<SDL_Rect>& extents, const unsigned int category)
+ *      batch : Entities to insert or refresh, nullptr entries are skipped
+ *      boxes : Movement hitbox of each entity in the batch
+ *      extents : Area each entity in the batch covers, see Quadtree::getExtent
+ *      category : CollisionCategory bits to add to each of their entries
+ *
+ * Description:
+ *      Same as the other insertBatch, but the hitboxes and extents are read from the arrays instead of
+ *      being built from each entity, for callers that already keep them.
+ */
+void SpatialGrid::insertBatch(const std::vector<Entity *>& batch, const std::vector<HitBox>& boxes,
+        const std::vector<SDL_Rect>& extents, const unsigned int category) {
+    refreshBatch(batch, &boxes, &extents, category);
+}
+
+/**
+ * Function Interface: void refreshBatch(const std::vector<Entity *>& batch, const std::vector<HitBox> *boxes,
+ *          const std::vector<SDL_Rect> *extents, const unsigned int category)
+ *      batch : Entities to insert or refresh
+ *      boxes : Movement hitboxes of the batch, or nullptr to build them from the entities
+ *      extents : Extents of the batch, or nullptr to build them from the entities
+ *      category : CollisionCategory bits to add to each of their entries
+ *
+ * Description:
+ *      Does the work of both insertBatch functions.
+ */
+void SpatialGrid::refreshBatch(const std::vector<Entity *>& batch, const std::vector<HitBox> *boxes,
+        const std::vector<SDL_Rect> *extents, const unsigned int category) {
+    const unsigned int threads = omp_get_max_threads();
+    if (staged.size() < threads) {
+        staged.resize(threads);
+    }
+    int width = maxWidth;
+    int height = maxHeight;
+
+#pragma omp parallel if(batch.size() >= GRID_BATCH_MIN) reduction(max: width, height)
+    {
+        auto& moves = staged[omp_get_thread_num()];
+        moves.clear();
+#pragma omp for schedule(static)
+        for (unsigned int i = 0; i < batch.size(); ++i) {
+            Entity *entity = batch[i];
+            if (!entity) {
+                continue;
+            }
+            const SDL_Rect extent = extents ? (*extents)[i] : Quadtree::getExtent(entity);
+            const unsigned int cell = cellOf(extent);
+            width = std::max(width, extent.w);
+            height = std::max(height, extent.h);
+
+            const Location *loc = locations.get(entity);
+            if (loc && loc->cell == cell && (cells[cell].getCategory(loc->index) & category) == category) {
+                if (boxes) {
+                    cells[cell].setBox(loc->index, (*boxes)[i]);
+                } else {
+                    cells[cell].set(loc->index);
+                }
+            } else {
+                moves.emplace_back(entity, cell);
+            }
+        }
+    }
+    maxWidth = width;
+    maxHeight = height;
+
+    for (auto& moves : staged) {
+        for (const auto& move : moves) {
+            place(move.first, move.second, category);
+        }
+        moves.clear();
+    }
+}
+
+/**
+ * Function Interface: void remove(const Entity *entity, const unsigned int category)
+ *      entity : Entity to remove
+ *      category : CollisionCategory bits to take off its entry
+ *
+ * Description:
+ *      Takes category bits off an entity, removing it from the grid once it has none left.
+ *      Does nothing if it isn't in the grid.
+ */
+void SpatialGrid::remove(const Entity *entity, const unsigned int category) {
+    const Location *loc = locations.get(entity);
+    if (!loc) {
+        return;
+    }
+    BoxSet& cell = cells[loc->cell];
+    const unsigned int bits = cell.getCategory(loc->index) & ~category;
+    if (bits) {
+        cell.setCategory(loc->index, bits);
+        return;
+    }
+    removeFromCell(*loc);
+    locations.erase(entity);
+}
+
+/**
+ * Function Interface: void removeFromCell(const Location& loc)
+ *      loc : Cell and slot to empty
+ *
+ * Description:
+ *      Moves the last entity in the cell into the freed slot.
+ */
+void SpatialGrid::removeFromCell(const Location& loc) {
+    const Entity *moved = cells[loc.cell].swapPop(loc.index);
+    if (moved) {
+        locations.get(moved)->index = loc.index;
+    }
+}
+
+/**
+ * Function Interface: std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask) const
+ *      entity : Entity to check collisions
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Retrieve a vector of entities in the mask that are near the param entity.
+ */
+std::vector<Entity *> SpatialGrid::retrieve(const Entity *entity, const unsigned int mask) const {
+    if (!entity) {
+        return {};
+    }
+    std::vector<Entity *> retrieved;
+    retrieve(retrieved, Quadtree::getExtent(entity), mask);
+    return retrieved;
+}
+
+/**
+ * Function Interface: void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+ *          const unsigned int mask) const
+ *      retrieveList : List the found entities are appended to
+ *      rect : Area to search
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Appends every entity in the mask stored in a cell that could hold something touching the rect.
+ */
+void SpatialGrid::retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect, const unsigned int mask) const {
+    visit(rect, mask, [&retrieveList](Entity *e) {
+        retrieveList.push_back(e);
+        return false;
+    });
+}
+
+/**
+ * Function Interface: std::vector<Entity *> retrieve(const Point& start, const Point& end,
+ *          const unsigned int mask) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Retrieves every entity in the mask stored in a cell that could hold something the line passes through.
+ */
+std::vector<Entity *> SpatialGrid::retrieve(const Point& start, const Point& end, const unsigned int mask) const {
+    std::vector<Entity *> rtn;
+    visit(start, end, mask, [&rtn](Entity *e) {
+        rtn.push_back(e);
+        return false;
+    });
+    return rtn;
+}
@@ -0,0 +1,343 @@
+/*------------------------------------------------------------------------------
+* Header: SpatialGrid.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Uniform grid used for marines and zombies. They are all roughly the size of a
+*       map tile, so each one is kept in the single cell holding the top left corner of
+*       its extent and queries look back far enough to catch the largest entity in the grid.
+*       Anything outside the grid is kept in the nearest edge cell.
+*       visit() calls a functor with each candidate and stops as soon as it returns true.
+*       Each cell also keeps a copy of the movement hitbox of everything in it, refreshed by insert(),
+*       so movement checks can run as block tests without touching the entities.
+*       The per frame sweep inserts every marine and zombie, so the copies are at most a frame old.
+*       traceRay() walks the cells a line passes through in order, so a caller can stop once
+*       nothing further along the line could matter.
+*       Every entry carries CollisionCategory bits, so marines and zombies share one grid and
+*       each query only sees the categories in its mask.
+*       insertBatch() refreshes a whole list of entities at once. Entities that stay in their cell,
+*       nearly all of them in a frame, are refreshed in parallel since each only touches its own slot.
+*       The rest are staged per thread and moved afterwards in one serial pass.
+*
+------------------------------------------------------------------------------*/
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+#include <SDL2/SDL.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "BoxSet.h"
+#include "Category.h"
+#include "../basic/Entity.h"
+#include "../buildings/Base.h"
+#include "../game/FlatMap.h"
+
+//smallest batch worth refreshing on more than one thread
+static constexpr unsigned int GRID_BATCH_MIN = 256;
+
+class SpatialGrid {
+public:
+    SpatialGrid(const SDL_Rect& pBounds, const int pCellSize);
+    ~SpatialGrid() = default;
+
+    void reset(const SDL_Rect& pBounds, const int pCellSize);
+    void clear();
+    void reserve(const unsigned int n) {locations.reserve(n);} // Inserting up to n entities in all won't allocate a location
+    unsigned int getSize() const {return locations.size();}
+    bool insert(Entity *entity, const unsigned int category);
+    void insertBatch(const std::vector<Entity *>& batch, const unsigned int category);
+    void insertBatch(const std::vector<Entity *>& batch, const std::vector<HitBox>& boxes,
+        const std::vector<SDL_Rect>& extents, const unsigned int category);
+    void remove(const Entity *entity, const unsigned int category = CollisionCategory::ALL);
+    bool contains(const Entity *entity) const {return locations.contains(entity);}
+    std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask = CollisionCategory::ALL) const;
+    void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+        const unsigned int mask = CollisionCategory::ALL) const;
+    std::vector<Entity *> retrieve(const Point& start, const Point& end,
+        const unsigned int mask = CollisionCategory::ALL) const;
+
+    template<typename Visitor>
+    bool visit(const unsigned int mask, Visitor&& visitor) const;
+    template<typename Visitor>
+    bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const;
+    template<typename Visitor>
+    bool visit(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor) const;
+    template<typename Visitor>
+    bool visitOverlapping(const SDL_Rect& rect, const bool friendly, const unsigned int mask,
+        Visitor&& visitor) const;
+    template<typename Visitor, typename Stop>
+    void traceRay(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor,
+        Stop&& stop) const;
+
+    const SDL_Rect& getBounds() const {return bounds;}
+    int getCellSize() const {return cellSize;}
+
+private:
+    struct Location {
+        unsigned int cell;
+        unsigned int index;
+    };
+
+    int cellX(const int x) const;
+    int cellY(const int y) const;
+    unsigned int cellOf(const SDL_Rect& extent) const;
+    bool place(Entity *entity, const unsigned int cell, const unsigned int category);
+    void refreshBatch(const std::vector<Entity *>& batch, const std::vector<HitBox> *boxes,
+        const std::vector<SDL_Rect> *extents, const unsigned int category);
+    void removeFromCell(const Location& loc);
+
+    SDL_Rect bounds;
+    int cellSize;
+    int cols;
+    int rows;
+    //largest extent inserted since the last reset, queries are widened by this much
+    int maxWidth;
+    int maxHeight;
+    std::vector<BoxSet> cells;
+    FlatMap<const Entity *, Location> locations;
+    //entities each thread found had to be added or moved during insertBatch
+    std::vector<std::vector<std::pair<Entity *, unsigned int>>> staged;
+};
+
+/**
+ * Function Interface: bool visit(const unsigned int mask, Visitor&& visitor) const
+ *      mask : Categories to visit
+ *      visitor : Called with every entity in the mask, returning true stops the search
+ *
+ * Description:
+ *      Visits every entry in the mask wherever it is. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool SpatialGrid::visit(const unsigned int mask, Visitor&& visitor) const {
+    for (const auto& cell : cells) {
+        if (cell.visit(mask, visitor)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const
+ *      rect : Area to search
+ *      mask : Categories to search
+ *      visitor : Called with every entity in the mask in a cell that could hold something touching the rect,
+ *                returning true stops the search
+ *
+ * Description:
+ *      Searches the grid without allocating. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool SpatialGrid::visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const {
+    const int startX = cellX(rect.x - maxWidth);
+    const int endX = cellX(rect.x + rect.w);
+    const int startY = cellY(rect.y - maxHeight);
+    const int endY = cellY(rect.y + rect.h);
+
+    for (int y = startY; y <= endY; ++y) {
+        for (int x = startX; x <= endX; ++x) {
+            if (cells[y * cols + x].visit(mask, visitor)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visit(const Point& start, const Point& end, const unsigned int mask,
+ *          Visitor&& visitor) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to search
+ *      visitor : Called with every entity in the mask in a cell that could hold something the line passes through,
+ *                returning true stops the search
+ *
+ * Description:
+ *      Searches the grid along a line without allocating. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool SpatialGrid::visit(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor) const {
+    const int left = std::min(start.first, end.first);
+    const int top = std::min(start.second, end.second);
+    const int right = std::max(start.first, end.first);
+    const int bottom = std::max(start.second, end.second);
+
+    const int startX = cellX(left - maxWidth);
+    const int endX = cellX(right);
+    const int startY = cellY(top - maxHeight);
+    const int endY = cellY(bottom);
+
+    for (int y = startY; y <= endY; ++y) {
+        for (int x = startX; x <= endX; ++x) {
+            const auto& cell = cells[y * cols + x];
+            if (cell.empty()) {
+                continue;
+            }
+            //edge cells also hold everything outside the grid so they are always searched
+            if (x && y && x != cols - 1 && y != rows - 1) {
+                //area an entity starting in this cell can reach
+                const SDL_Rect area = {bounds.x + x * cellSize, bounds.y + y * cellSize,
+                    cellSize + maxWidth, cellSize + maxHeight};
+                //SDL clips the line in place so it needs its own copy each time
+                int x1 = start.first;
+                int y1 = start.second;
+                int x2 = end.first;
+                int y2 = end.second;
+                if (!SDL_IntersectRectAndLine(&area, &x1, &y1, &x2, &y2)) {
+                    continue;
+                }
+            }
+            if (cell.visit(mask, visitor)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visitOverlapping(const SDL_Rect& rect, const bool friendly, const unsigned int mask,
+ *          Visitor&& visitor) const
+ *      rect : Movement hitbox to test
+ *      friendly : Whether the tested hitbox is player friendly
+ *      mask : Categories to test against
+ *      visitor : Called with every entity in the mask whose stored movement hitbox overlaps the rect and
+ *                is not friendly to it, returning true stops the search
+ *
+ * Description:
+ *      Runs the block overlap test over every cell that could hold something touching the rect.
+ *      Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool SpatialGrid::visitOverlapping(const SDL_Rect& rect, const bool friendly, const unsigned int mask,
+        Visitor&& visitor) const {
+    const int startX = cellX(rect.x - maxWidth);
+    const int endX = cellX(rect.x + rect.w);
+    const int startY = cellY(rect.y - maxHeight);
+    const int endY = cellY(rect.y + rect.h);
+
+    for (int y = startY; y <= endY; ++y) {
+        for (int x = startX; x <= endX; ++x) {
+            if (cells[y * cols + x].visitOverlapping(rect, friendly, mask, visitor)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: void traceRay(const Point& start, const Point& end, const unsigned int mask,
+ *          Visitor&& visitor, Stop&& stop) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to search
+ *      visitor : Called with every entity in the mask that could be hit along the line
+ *      stop : Called with how far along the line has been searched, from 0 to 1,
+ *             returning true ends the search
+ *
+ * Description:
+ *      Steps through the cells under the line in order (Amanatides and Woo). Entities reach down
+ *      and right from the cell they are kept in, so each step also searches the cells up to the
+ *      largest extent back from the one under the line, and one cell forward. Cells are marked
+ *      as they are searched so none is searched twice.
+ *      Once stop has been called with a value, every entity the line touches before that point has
+ *      been given to the visitor. Lines leaving the grid search every cell they might touch and call
+ *      stop once at the end.
+ */
+template<typename Visitor, typename Stop>
+void SpatialGrid::traceRay(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor,
+        Stop&& stop) const {
+    const auto inside = [this](const Point& p) {
+        return p.first >= bounds.x && p.first < bounds.x + bounds.w
+            && p.second >= bounds.y && p.second < bounds.y + bounds.h;
+    };
+    if (!inside(start) || !inside(end)) {
+        visit(start, end, mask, [&visitor](Entity *e) {
+            visitor(e);
+            return false;
+        });
+        stop(1.0f);
+        return;
+    }
+
+    //cells back from the one under the line that can hold something reaching it, with a pixel
+    //to spare since SDL clips lines to whole pixels and can hit boxes the line only grazes
+    const int spanX = (maxWidth + 1) / cellSize + 1;
+    const int spanY = (maxHeight + 1) / cellSize + 1;
+
+    //marks the cells this trace has searched, a new trace just uses the next number
+    thread_local std::vector<unsigned int> searched;
+    thread_local unsigned int trace = 0;
+    if (searched.size() < cells.size()) {
+        searched.resize(cells.size(), 0);
+    }
+    if (++trace == 0) {
+        std::fill(searched.begin(), searched.end(), 0);
+        trace = 1;
+    }
+    const auto searchAround = [&](const int cellCol, const int cellRow) {
+        for (int y = std::max(cellRow - spanY, 0); y <= std::min(cellRow + 1, rows - 1); ++y) {
+            for (int x = std::max(cellCol - spanX, 0); x <= std::min(cellCol + 1, cols - 1); ++x) {
+                const unsigned int index = y * cols + x;
+                if (searched[index] == trace) {
+                    continue;
+                }
+                searched[index] = trace;
+                cells[index].visit(mask, [&visitor](Entity *e) {
+                    visitor(e);
+                    return false;
+                });
+            }
+        }
+    };
+
+    const float dx = end.first - start.first;
+    const float dy = end.second - start.second;
+    int x = cellX(start.first);
+    int y = cellY(start.second);
+    const int lastX = cellX(end.first);
+    const int lastY = cellY(end.second);
+    const int stepX = dx > 0 ? 1 : -1;
+    const int stepY = dy > 0 ? 1 : -1;
+
+    //how far along the line the next vertical and horizontal cell edges are, and the gap between them
+    const float deltaX = dx ? cellSize / std::fabs(dx) : HUGE_VALF;
+    const float deltaY = dy ? cellSize / std::fabs(dy) : HUGE_VALF;
+    float nextX = dx ? (bounds.x + (x + (dx > 0)) * cellSize - start.first) / dx : HUGE_VALF;
+    float nextY = dy ? (bounds.y + (y + (dy > 0)) * cellSize - start.second) / dy : HUGE_VALF;
+
+    searchAround(x, y);
+    for (;;) {
+        const float reached = std::min(std::min(nextX, nextY), 1.0f);
+        if (stop(reached) || (x == lastX && y == lastY) || reached >= 1.0f) {
+            return;
+        }
+        if (nextX < nextY) {
+            x += stepX;
+            nextX += deltaX;
+        } else {
+            y += stepY;
+            nextY += deltaY;
+        }
+        if (x < 0 || x >= cols || y < 0 || y >= rows) {
+            return;
+        }
+        searchAround(x, y);
+    }
+}
+
+#endif
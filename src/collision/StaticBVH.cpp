@@ -0,0 +1,241 @@
+/*------------------------------------------------------------------------------
+* Header: StaticBVH.cpp
+*
+* Functions:
+*       void add(Entity *entity, const unsigned int category)
+*       void remove(const Entity *entity, const unsigned int category)
+*       void clear()
+*       void build()
+*       std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask) const
+*       void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect, const unsigned int mask) const
+*       std::vector<Entity *> retrieve(const Point& start, const Point& end, const unsigned int mask) const
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*
+------------------------------------------------------------------------------*/
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <utility>
+#include "StaticBVH.h"
+#include "Quadtree.h"
+
+/**
+ * Function Interface: void add(Entity *entity, const unsigned int category)
+ *      entity : Static entity to add
+ *      category : CollisionCategory bits to add to its entry
+ *
+ * Description:
+ *      Adds an entity to the hierarchy. It is not part of the tree until build() is called.
+ *      Adding an entity that is already in the hierarchy only adds the category bits.
+ */
+void StaticBVH::add(Entity *entity, const unsigned int category) {
+    if (!entity) {
+        return;
+    }
+    for (auto& p : prims) {
+        if (p.entity == entity) {
+            p.category |= category;
+            return;
+        }
+    }
+    prims.push_back({Quadtree::getExtent(entity), entity, category});
+    built = false;
+}
+
+/**
+ * Function Interface: void remove(const Entity *entity, const unsigned int category)
+ *      entity : Entity to remove
+ *      category : CollisionCategory bits to take off its entry
+ *
+ * Description:
+ *      Takes category bits off an entity, removing it from the hierarchy once it has none left.
+ *      The tree needs to be built again after an entity is removed.
+ */
+void StaticBVH::remove(const Entity *entity, const unsigned int category) {
+    const auto it = std::find_if(prims.begin(), prims.end(), [entity](const Prim& p) {
+        return p.entity == entity;
+    });
+    if (it != prims.end()) {
+        it->category &= ~category;
+        if (it->category) {
+            return;
+        }
+        prims.erase(it);
+        built = false;
+    }
+}
+
+/**
+ * Function Interface: void clear()
+ *
+ * Description:
+ *      Removes everything from the hierarchy.
+ */
+void StaticBVH::clear() {
+    prims.clear();
+    nodes.clear();
+    built = false;
+}
+
+/**
+ * Function Interface: void build()
+ *
+ * Description:
+ *      Builds the tree over every entity that has been added. Does nothing if it is up to date.
+ */
+void StaticBVH::build() {
+    if (built) {
+        return;
+    }
+    nodes.clear();
+    if (!prims.empty()) {
+        nodes.reserve(2 * (prims.size() / BVH_LEAF_SIZE + 1));
+        buildNode(0, prims.size());
+    }
+    built = true;
+}
+
+/**
+ * Function Interface: unsigned int buildNode(const unsigned int first, const unsigned int last)
+ *      first : First entity covered by the node
+ *      last : One past the last entity covered by the node
+ *
+ * Description:
+ *      Builds a node and everything below it, splitting the entities at the median of
+ *      the longest axis. Returns the index of the node.
+ */
+unsigned int StaticBVH::buildNode(const unsigned int first, const unsigned int last) {
+    int left = prims[first].box.x;
+    int top = prims[first].box.y;
+    int right = left + prims[first].box.w;
+    int bottom = top + prims[first].box.h;
+    for (unsigned int i = first + 1; i < last; ++i) {
+        const SDL_Rect& b = prims[i].box;
+        left = std::min(left, b.x);
+        top = std::min(top, b.y);
+        right = std::max(right, b.x + b.w);
+        bottom = std::max(bottom, b.y + b.h);
+    }
+
+    const unsigned int index = nodes.size();
+    nodes.push_back({{left, top, right - left, bottom - top}, first, last - first});
+    if (last - first <= BVH_LEAF_SIZE) {
+        return index;
+    }
+
+    //sort by centre along the longest axis, the centres are doubled to stay in integers
+    const bool splitX = (right - left) >= (bottom - top);
+    const unsigned int mid = first + (last - first) / 2;
+    std::nth_element(prims.begin() + first, prims.begin() + mid, prims.begin() + last,
+        [splitX](const Prim& a, const Prim& b) {
+            return splitX ? (2 * a.box.x + a.box.w) < (2 * b.box.x + b.box.w)
+                : (2 * a.box.y + a.box.h) < (2 * b.box.y + b.box.h);
+        });
+
+    buildNode(first, mid);
+    const unsigned int rightChild = buildNode(mid, last);
+    nodes[index].offset = rightChild;
+    nodes[index].count = 0;
+    return index;
+}
+
+/**
+ * Function Interface: std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask) const
+ *      entity : Entity to check collisions
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Retrieve a vector of static entities in the mask that are near the param entity.
+ */
+std::vector<Entity *> StaticBVH::retrieve(const Entity *entity, const unsigned int mask) const {
+    if (!entity) {
+        return {};
+    }
+    std::vector<Entity *> retrieved;
+    retrieve(retrieved, Quadtree::getExtent(entity), mask);
+    return retrieved;
+}
+
+/**
+ * Function Interface: void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+ *          const unsigned int mask) const
+ *      retrieveList : List the found entities are appended to
+ *      rect : Area to search
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Appends every entity in the mask whose bounds overlap the rect.
+ */
+void StaticBVH::retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect, const unsigned int mask) const {
+    visit(rect, mask, [&retrieveList](Entity *e) {
+        retrieveList.push_back(e);
+        return false;
+    });
+}
+
+/**
+ * Function Interface: std::vector<Entity *> retrieve(const Point& start, const Point& end,
+ *          const unsigned int mask) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to retrieve
+ *
+ * Description:
+ *      Retrieves every entity in the mask whose bounds the line passes through.
+ */
+std::vector<Entity *> StaticBVH::retrieve(const Point& start, const Point& end, const unsigned int mask) const {
+    std::vector<Entity *> rtn;
+    visit(start, end, mask, [&rtn](Entity *e) {
+        rtn.push_back(e);
+        return false;
+    });
+    return rtn;
+}
+
+/**
+ * Function Interface: bool segmentHitsBox(const SDL_Rect& box, const float x1, const float y1,
+ *          const float x2, const float y2)
+ *      box : Box to test
+ *      x1, y1 : Start of the segment
+ *      x2, y2 : End of the segment
+ *
+ * Description:
+ *      Slab test of a line segment against a box.
+ */
+bool StaticBVH::segmentHitsBox(const SDL_Rect& box, const float x1, const float y1,
+        const float x2, const float y2) {
+    float tMin = 0;
+    float tMax = 1;
+    const float origin[] = {x1, y1};
+    const float delta[] = {x2 - x1, y2 - y1};
+    const float low[] = {static_cast<float>(box.x), static_cast<float>(box.y)};
+    const float high[] = {static_cast<float>(box.x + box.w), static_cast<float>(box.y + box.h)};
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (delta[axis] == 0) {
+            if (origin[axis] < low[axis] || origin[axis] > high[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (low[axis] - origin[axis]) / delta[axis];
+        float t2 = (high[axis] - origin[axis]) / delta[axis];
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        if (tMin > tMax) {
+            return false;
+        }
+    }
+    return true;
+}
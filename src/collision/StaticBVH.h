@@ -0,0 +1,173 @@
+/*------------------------------------------------------------------------------
+* Header: StaticBVH.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Bounding volume hierarchy for geometry that never moves, the map walls and the base.
+*       Entities are added as the map is loaded and the tree is built once by build().
+*       Nodes are stored depth first in a single vector, a node's left child directly follows it,
+*       and the entities are reordered so every leaf covers a contiguous run of them.
+*       Until build() is called queries fall back to checking every entity.
+*       visit() calls a functor with each entity whose bounds are hit and stops as soon as it returns true.
+*       Every entry carries CollisionCategory bits and queries only see the categories in their mask.
+*
+------------------------------------------------------------------------------*/
+#ifndef STATICBVH_H
+#define STATICBVH_H
+#include <SDL2/SDL.h>
+#include <vector>
+#include <array>
+
+#include "Category.h"
+#include "../basic/Entity.h"
+#include "../buildings/Base.h"
+
+//most entities a leaf will hold before it is split
+static constexpr unsigned int BVH_LEAF_SIZE = 4;
+
+class StaticBVH {
+public:
+    StaticBVH() = default;
+    ~StaticBVH() = default;
+
+    void add(Entity *entity, const unsigned int category);
+    void remove(const Entity *entity, const unsigned int category = CollisionCategory::ALL);
+    void clear();
+    void build();
+    bool isBuilt() const {return built;}
+    unsigned int getSize() const {return prims.size();}
+
+    std::vector<Entity *> retrieve(const Entity *entity, const unsigned int mask = CollisionCategory::ALL) const;
+    void retrieve(std::vector<Entity *>& retrieveList, const SDL_Rect& rect,
+        const unsigned int mask = CollisionCategory::ALL) const;
+    std::vector<Entity *> retrieve(const Point& start, const Point& end,
+        const unsigned int mask = CollisionCategory::ALL) const;
+
+    template<typename Visitor>
+    bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const;
+    template<typename Visitor>
+    bool visit(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor) const;
+
+private:
+    struct Prim {
+        SDL_Rect box;
+        Entity *entity;
+        //CollisionCategory bits of the entry
+        unsigned int category;
+    };
+
+    struct Node {
+        SDL_Rect box;
+        //first entity of a leaf, or the index of the right child of an inner node
+        unsigned int offset;
+        //number of entities in a leaf, 0 for inner nodes
+        unsigned int count;
+    };
+
+    unsigned int buildNode(const unsigned int first, const unsigned int last);
+    static bool segmentHitsBox(const SDL_Rect& box, const float x1, const float y1, const float x2, const float y2);
+
+    //walks the tree calling visitor on every entity whose box passes the test
+    template<typename Test, typename Visitor>
+    bool walk(Test&& test, const unsigned int mask, Visitor&& visitor) const;
+
+    std::vector<Prim> prims;
+    std::vector<Node> nodes;
+    bool built = false;
+};
+
+/**
+ * Function Interface: bool walk(Test&& test, const unsigned int mask, Visitor&& visitor) const
+ *      test : Returns whether a box should be searched
+ *      mask : Categories to search
+ *      visitor : Called with every entity in the mask whose box passes the test, returning true stops the search
+ *
+ * Description:
+ *      Shared traversal for the visit functions. Returns true if the visitor stopped the search.
+ */
+template<typename Test, typename Visitor>
+bool StaticBVH::walk(Test&& test, const unsigned int mask, Visitor&& visitor) const {
+    if (!built) {
+        for (const auto& p : prims) {
+            if ((p.category & mask) && test(p.box) && visitor(p.entity)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    if (nodes.empty()) {
+        return false;
+    }
+
+    std::array<unsigned int, 64> stack;
+    unsigned int top = 0;
+    stack[top++] = 0;
+
+    while (top) {
+        const unsigned int index = stack[--top];
+        const Node& n = nodes[index];
+        if (!test(n.box)) {
+            continue;
+        }
+        if (n.count) {
+            for (unsigned int i = n.offset; i < n.offset + n.count; ++i) {
+                if ((prims[i].category & mask) && test(prims[i].box) && visitor(prims[i].entity)) {
+                    return true;
+                }
+            }
+        } else {
+            stack[top++] = n.offset;
+            stack[top++] = index + 1;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function Interface: bool visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const
+ *      rect : Area to search
+ *      mask : Categories to search
+ *      visitor : Called with every entity in the mask whose bounds overlap the rect, returning true stops the search
+ *
+ * Description:
+ *      Searches the hierarchy without allocating. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool StaticBVH::visit(const SDL_Rect& rect, const unsigned int mask, Visitor&& visitor) const {
+    return walk([&rect](const SDL_Rect& box) {
+        return SDL_HasIntersection(&box, &rect);
+    }, mask, visitor);
+}
+
+/**
+ * Function Interface: bool visit(const Point& start, const Point& end, const unsigned int mask,
+ *          Visitor&& visitor) const
+ *      start : Start of the line
+ *      end : End of the line
+ *      mask : Categories to search
+ *      visitor : Called with every entity in the mask whose bounds the line passes through,
+ *                returning true stops the search
+ *
+ * Description:
+ *      Searches the hierarchy along a line without allocating. Returns true if the visitor stopped the search.
+ */
+template<typename Visitor>
+bool StaticBVH::visit(const Point& start, const Point& end, const unsigned int mask, Visitor&& visitor) const {
+    return walk([&start, &end](const SDL_Rect& box) {
+        //a pixel wider on each side since SDL clips lines to whole pixels and can hit boxes the line only grazes
+        const SDL_Rect grown = {box.x - 1, box.y - 1, box.w + 2, box.h + 2};
+        return segmentHitsBox(grown, start.first, start.second, end.first, end.second);
+    }, mask, visitor);
+}
+
+#endif
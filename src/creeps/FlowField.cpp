@@ -0,0 +1,295 @@
+/*------------------------------------------------------------------------------
+* Source: FlowField.cpp
+*
+* Functions:
+*       void build(const AiGrid& walls, const SDL_Rect& goal)
+*       void block(const int col, const int row)
+*       void unblock(const int col, const int row)
+*       bool tileAt(const float x, const float y, int& col, int& row)
+*       bool nextStep(const float x, const float y, int& stepX, int& stepY) const
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*
+------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include "FlowField.h"
+
+constexpr int FlowField::UNREACHABLE;
+constexpr uint8_t FlowField::NO_DIRECTION;
+
+FlowField::FlowField() : built(false), walls(), obstacles() {
+    for (auto& row : distance) {
+        row.fill(UNREACHABLE);
+    }
+    for (auto& row : direction) {
+        row.fill(NO_DIRECTION);
+    }
+}
+
+/**
+ * Function Interface: void build(const AiGrid& walls, const SDL_Rect& goal)
+ *      walls : AI map, true for tiles with a wall on them
+ *      goal : Area in map coordinates to reach, every tile it touches is a goal tile
+ *
+ * Description:
+ *      Runs Dijkstra from every goal tile at once. Whenever a tile is reached by a shorter path it is
+ *      pointed back at the tile it was reached from, so once the search is done every reachable
+ *      tile points along its shortest path to the goal.
+ *      The walls are kept so the field can be repaired later, and obstacles already placed stay blocked.
+ */
+void FlowField::build(const AiGrid& walls, const SDL_Rect& goal) {
+    this->walls = walls;
+    for (auto& row : distance) {
+        row.fill(UNREACHABLE);
+    }
+    for (auto& row : direction) {
+        row.fill(NO_DIRECTION);
+    }
+    frontier.clear();
+
+    const int firstCol = std::max(goal.x / T_SIZE, 0);
+    const int lastCol = std::min((goal.x + goal.w - 1) / T_SIZE, M_WIDTH - 1);
+    const int firstRow = std::max(goal.y / T_SIZE, 0);
+    const int lastRow = std::min((goal.y + goal.h - 1) / T_SIZE, M_HEIGHT - 1);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int col = firstCol; col <= lastCol; ++col) {
+            distance[row][col] = 0;
+            frontier.emplace_back(0, row * M_WIDTH + col);
+        }
+    }
+    settle();
+    built = true;
+}
+
+/**
+ * Function Interface: void block(const int col, const int row)
+ *      col : Column of the tile an obstacle was placed on
+ *      row : Row of the tile an obstacle was placed on
+ *
+ * Description:
+ *      Counts the obstacle, and if it closes the tile, clears every tile whose path ran through it,
+ *      or cut past its corner, then fills the cleared tiles back in from the tiles around them.
+ *      Goal tiles stay goals.
+ */
+void FlowField::block(const int col, const int row) {
+    if (col < 0 || col >= M_WIDTH || row < 0 || row >= M_HEIGHT) {
+        return;
+    }
+    if (obstacles[row][col]++ || walls[row][col] || !built || !distance[row][col]) {
+        return;
+    }
+    clearThrough(col, row);
+    frontier.clear();
+    for (const int tile : cleared) {
+        seedAround(tile % M_WIDTH, tile / M_WIDTH);
+    }
+    settle();
+}
+
+/**
+ * Function Interface: void unblock(const int col, const int row)
+ *      col : Column of the tile an obstacle was removed from
+ *      row : Row of the tile an obstacle was removed from
+ *
+ * Description:
+ *      Counts the obstacle off, and if that opens the tile, lets every neighbour offer it a path.
+ *      Relaxing the neighbours again also retries the diagonal steps past its corners. Distances only
+ *      get shorter, so the search stops at the first tiles whose paths don't improve.
+ */
+void FlowField::unblock(const int col, const int row) {
+    if (col < 0 || col >= M_WIDTH || row < 0 || row >= M_HEIGHT || !obstacles[row][col]) {
+        return;
+    }
+    if (--obstacles[row][col] || walls[row][col] || !built) {
+        return;
+    }
+    frontier.clear();
+    seedAround(col, row);
+    settle();
+}
+
+/**
+ * Function Interface: bool tileAt(const float x, const float y, int& col, int& row)
+ *      x : Point in map coordinates
+ *      y : Point in map coordinates
+ *      col : Set to the column of the tile holding the point
+ *      row : Set to the row of the tile holding the point
+ *
+ * Description:
+ *      Returns false if the point is off the map.
+ */
+bool FlowField::tileAt(const float x, const float y, int& col, int& row) {
+    col = std::floor(x / T_SIZE);
+    row = std::floor(y / T_SIZE);
+    return col >= 0 && col < M_WIDTH && row >= 0 && row < M_HEIGHT;
+}
+
+/**
+ * Function Interface: bool nextStep(const float x, const float y, int& stepX, int& stepY) const
+ *      x : Point in map coordinates, usually the middle of a zombie
+ *      y : Point in map coordinates
+ *      stepX : Set to the middle of the next tile on the way to the goal
+ *      stepY : Set to the middle of the next tile on the way to the goal
+ *
+ * Description:
+ *      Returns false without setting the step if the point is on a goal tile, off the map, on a wall,
+ *      or can't reach the goal. The caller can then head straight for the goal instead.
+ */
+bool FlowField::nextStep(const float x, const float y, int& stepX, int& stepY) const {
+    int col;
+    int row;
+    if (!built || !tileAt(x, y, col, row)) {
+        return false;
+    }
+    const uint8_t dir = direction[row][col];
+    if (dir == NO_DIRECTION) {
+        return false;
+    }
+    stepX = (col + STEP_COL[dir]) * T_SIZE + T_SIZE / 2;
+    stepY = (row + STEP_ROW[dir]) * T_SIZE + T_SIZE / 2;
+    return true;
+}
+
+/**
+ * Function Interface: void settle()
+ *
+ * Description:
+ *      Runs Dijkstra from whatever tiles are in the frontier, settling them nearest first.
+ */
+void FlowField::settle() {
+    //min heap on distance
+    const auto later = std::greater<std::pair<int, int>>();
+    std::make_heap(frontier.begin(), frontier.end(), later);
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        const std::pair<int, int> tile = frontier.back();
+        frontier.pop_back();
+        const int col = tile.second % M_WIDTH;
+        const int row = tile.second / M_WIDTH;
+        //stale entry left behind when the tile was reached again by a shorter path
+        if (tile.first > distance[row][col]) {
+            continue;
+        }
+        relax(col, row);
+    }
+}
+
+/**
+ * Function Interface: void relax(const int col, const int row)
+ *      col : Column of a tile that was just settled
+ *      row : Row of a tile that was just settled
+ *
+ * Description:
+ *      Offers every open neighbour of a settled tile a path through it. Diagonal steps are only
+ *      taken when both tiles beside the corner are open, so nothing is walked into a wall's corner.
+ */
+void FlowField::relax(const int col, const int row) {
+    const int here = distance[row][col];
+    for (int k = 0; k < NO_DIRECTION; ++k) {
+        const int nextCol = col + STEP_COL[k];
+        const int nextRow = row + STEP_ROW[k];
+        if (!open(nextCol, nextRow)) {
+            continue;
+        }
+        if (k >= FIRST_DIAGONAL && !(open(nextCol, row) && open(col, nextRow))) {
+            continue;
+        }
+        const int through = here + (k >= FIRST_DIAGONAL ? DIAGONAL_COST : STRAIGHT_COST);
+        if (through < distance[nextRow][nextCol]) {
+            distance[nextRow][nextCol] = through;
+            direction[nextRow][nextCol] = k ^ 1;
+            frontier.emplace_back(through, nextRow * M_WIDTH + nextCol);
+            std::push_heap(frontier.begin(), frontier.end(), std::greater<std::pair<int, int>>());
+        }
+    }
+}
+
+/**
+ * Function Interface: void seedAround(const int col, const int row)
+ *      col : Column of a tile
+ *      row : Row of a tile
+ *
+ * Description:
+ *      Adds every open neighbour of the tile that can reach the goal to the frontier, so settling
+ *      offers their paths to the tile again.
+ */
+void FlowField::seedAround(const int col, const int row) {
+    for (int k = 0; k < NO_DIRECTION; ++k) {
+        const int nextCol = col + STEP_COL[k];
+        const int nextRow = row + STEP_ROW[k];
+        if (open(nextCol, nextRow) && distance[nextRow][nextCol] != UNREACHABLE) {
+            frontier.emplace_back(distance[nextRow][nextCol], nextRow * M_WIDTH + nextCol);
+        }
+    }
+}
+
+/**
+ * Function Interface: void clearThrough(const int col, const int row)
+ *      col : Column of a tile that just closed
+ *      row : Row of a tile that just closed
+ *
+ * Description:
+ *      Makes unreachable the closed tile, the tiles beside it that stepped diagonally past its corner,
+ *      and every tile whose path led through any of those, listing them all in cleared.
+ *      Every other tile keeps its path, none of them used the closed tile.
+ */
+void FlowField::clearThrough(const int col, const int row) {
+    cleared.clear();
+    const auto clear = [this](const int c, const int r) {
+        distance[r][c] = UNREACHABLE;
+        direction[r][c] = NO_DIRECTION;
+        cleared.push_back(r * M_WIDTH + c);
+    };
+    clear(col, row);
+    //the sides come first in the offsets
+    for (int k = 0; k < FIRST_DIAGONAL; ++k) {
+        const int sideCol = col + STEP_COL[k];
+        const int sideRow = row + STEP_ROW[k];
+        if (!open(sideCol, sideRow) || direction[sideRow][sideCol] < FIRST_DIAGONAL
+                || direction[sideRow][sideCol] == NO_DIRECTION) {
+            continue;
+        }
+        const uint8_t dir = direction[sideRow][sideCol];
+        if ((sideCol + STEP_COL[dir] == col && sideRow == row) || (sideCol == col && sideRow + STEP_ROW[dir] == row)) {
+            clear(sideCol, sideRow);
+        }
+    }
+    //anything pointing at a cleared tile was cleared along with it
+    for (unsigned int i = 0; i < cleared.size(); ++i) {
+        const int tileCol = cleared[i] % M_WIDTH;
+        const int tileRow = cleared[i] / M_WIDTH;
+        for (int k = 0; k < NO_DIRECTION; ++k) {
+            const int nextCol = tileCol + STEP_COL[k];
+            const int nextRow = tileRow + STEP_ROW[k];
+            if (nextCol < 0 || nextCol >= M_WIDTH || nextRow < 0 || nextRow >= M_HEIGHT) {
+                continue;
+            }
+            //pointing back along k ^ 1 means it steps onto this tile
+            if (direction[nextRow][nextCol] == (k ^ 1)) {
+                clear(nextCol, nextRow);
+            }
+        }
+    }
+}
+
+/**
+ * Function Interface: bool open(const int col, const int row) const
+ *      col : Column of the tile
+ *      row : Row of the tile
+ *
+ * Description:
+ *      Returns true if the tile is on the map and has no wall or obstacle on it.
+ */
+bool FlowField::open(const int col, const int row) const {
+    return col >= 0 && col < M_WIDTH && row >= 0 && row < M_HEIGHT && !walls[row][col] && !obstacles[row][col];
+}
@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+* Header: FlowField.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Path to a goal for every tile of the map at once, shared by every zombie heading there.
+*       build() runs Dijkstra out from the goal tiles over the AI map, with diagonal steps costing
+*       DIAGONAL_COST and never cutting the corner of a wall. Each tile is pointed at the neighbour it
+*       was reached from, which is the next tile on its shortest path to the goal. Finding where to
+*       walk next is then a lookup of the tile the zombie is on.
+*       Barricades and turrets block the tile under their middle while they are placed. Instead of
+*       building the field again, block() and unblock() only redo the tiles the change can affect.
+*       Blocking a tile clears every tile whose path ran through it and fills them back in from the
+*       tiles around them. Unblocking one lets its neighbours offer it, and everything past it, a
+*       shorter path. Both do the same work a full build would do for the tiles that change, and
+*       nothing for the rest.
+*
+------------------------------------------------------------------------------*/
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <utility>
+
+#include "../map/Map.h"
+
+//walls of the AI map, true where a tile is blocked
+typedef std::array<std::array<bool, M_WIDTH>, M_HEIGHT> AiGrid;
+
+//cost of stepping to the tile beside and to the tile diagonal, about 10 and 10 * sqrt 2
+static constexpr int STRAIGHT_COST = 10;
+static constexpr int DIAGONAL_COST = 14;
+//neighbour offsets, the four sides then the four diagonals, each beside its opposite so k ^ 1 reverses k
+static constexpr int STEP_COL[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+static constexpr int STEP_ROW[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+//offsets from here on are diagonal
+static constexpr int FIRST_DIAGONAL = 4;
+
+class FlowField {
+public:
+    //distance of tiles that can't reach the goal
+    static constexpr int UNREACHABLE = INT_MAX;
+    //direction of goal and unreachable tiles
+    static constexpr uint8_t NO_DIRECTION = 8;
+
+    FlowField();
+    ~FlowField() = default;
+
+    void build(const AiGrid& walls, const SDL_Rect& goal);
+
+    // One more or one fewer obstacle on a tile, repairing the field when the tile opens or closes
+    void block(const int col, const int row);
+    void unblock(const int col, const int row);
+
+    // Tile holding a point in map coordinates, false if it is off the map
+    static bool tileAt(const float x, const float y, int& col, int& row);
+
+    // Middle of the tile to walk to next from the point, false if the point is on a goal tile,
+    // off the map, or can't reach the goal
+    bool nextStep(const float x, const float y, int& stepX, int& stepY) const;
+
+    int getDistance(const int col, const int row) const {return distance[row][col];}
+    uint8_t getDirection(const int col, const int row) const {return direction[row][col];}
+    bool isBuilt() const {return built;}
+
+private:
+    void settle();
+    void relax(const int col, const int row);
+    void seedAround(const int col, const int row);
+    void clearThrough(const int col, const int row);
+    bool open(const int col, const int row) const;
+
+    bool built;
+    AiGrid walls;
+    //barricades and turrets on each tile
+    std::array<std::array<uint8_t, M_WIDTH>, M_HEIGHT> obstacles;
+    std::array<std::array<int, M_WIDTH>, M_HEIGHT> distance;
+    //index into the neighbour offsets of the next tile towards the goal
+    std::array<std::array<uint8_t, M_WIDTH>, M_HEIGHT> direction;
+    //heap of tiles waiting to be settled as distance and row * M_WIDTH + col, kept to save reallocating
+    std::vector<std::pair<int, int>> frontier;
+    //tiles cleared by block() as row * M_WIDTH + col, kept to save reallocating
+    std::vector<int> cleared;
+};
+
+#endif
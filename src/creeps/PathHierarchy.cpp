@@ -0,0 +1,376 @@
+/*------------------------------------------------------------------------------
+* Source: PathHierarchy.cpp
+*
+* Functions:
+*       void build(const AiGrid& walls)
+*       bool nextStep(const float x, const float y, const float targetX, const float targetY,
+*           int& stepX, int& stepY) const
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*
+------------------------------------------------------------------------------*/
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include "PathHierarchy.h"
+
+//direction of the neighbour stepCol and stepRow away
+static uint8_t directionOf(const int stepCol, const int stepRow) {
+    for (int k = 0; k < FlowField::NO_DIRECTION; ++k) {
+        if (STEP_COL[k] == stepCol && STEP_ROW[k] == stepRow) {
+            return k;
+        }
+    }
+    return FlowField::NO_DIRECTION;
+}
+
+/**
+ * Function Interface: void build(const AiGrid& walls)
+ *      walls : AI map, true for tiles with a wall on them
+ *
+ * Description:
+ *      Puts an entrance on every open stretch of border between two clusters, then joins each node
+ *      to the other nodes of its cluster it can reach without leaving it. Anything cached was found on
+ *      the old walls, so it is thrown out.
+ */
+void PathHierarchy::build(const AiGrid& walls) {
+    this->walls = walls;
+    nodes.clear();
+    for (auto& cluster : clusterNodes) {
+        cluster.clear();
+    }
+    targetCache.clear();
+    clusterCache.clear();
+
+    for (int cluster = 0; cluster < CLUSTER_COLS * CLUSTER_ROWS; ++cluster) {
+        const Bounds b = boundsOf(cluster);
+        //border with the cluster to the right, then the one below
+        if (b.lastCol + 1 < M_WIDTH) {
+            int length = 0;
+            for (int row = b.firstRow; row <= b.lastRow + 1; ++row) {
+                if (row <= b.lastRow && open(b.lastCol, row) && open(b.lastCol + 1, row)) {
+                    ++length;
+                } else if (length) {
+                    addEntrances(b.lastCol, row - length, 0, 1, length);
+                    length = 0;
+                }
+            }
+        }
+        if (b.lastRow + 1 < M_HEIGHT) {
+            int length = 0;
+            for (int col = b.firstCol; col <= b.lastCol + 1; ++col) {
+                if (col <= b.lastCol && open(col, b.lastRow) && open(col, b.lastRow + 1)) {
+                    ++length;
+                } else if (length) {
+                    addEntrances(col - length, b.lastRow, 1, 0, length);
+                    length = 0;
+                }
+            }
+        }
+    }
+
+    std::array<int, CLUSTER_SIZE * CLUSTER_SIZE> distance;
+    ClusterRoute direction;
+    for (int cluster = 0; cluster < CLUSTER_COLS * CLUSTER_ROWS; ++cluster) {
+        const Bounds b = boundsOf(cluster);
+        for (const int from : clusterNodes[cluster]) {
+            searchCluster(cluster, {{nodes[from].col, nodes[from].row, 0, FlowField::NO_DIRECTION}},
+                distance, direction);
+            for (const int to : clusterNodes[cluster]) {
+                const int cost = distance[localIndex(b, nodes[to].col, nodes[to].row)];
+                if (to != from && cost != FlowField::UNREACHABLE) {
+                    nodes[from].edges.emplace_back(to, cost);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Function Interface: bool nextStep(const float x, const float y, const float targetX, const float targetY,
+ *          int& stepX, int& stepY) const
+ *      x : Point in map coordinates, usually the middle of a zombie
+ *      y : Point in map coordinates
+ *      targetX : Point to get to in map coordinates, usually the middle of a marine
+ *      targetY : Point to get to in map coordinates
+ *      stepX : Set to the middle of the next tile on the way
+ *      stepY : Set to the middle of the next tile on the way
+ *
+ * Description:
+ *      Looks up the direction of the tile the point is on in the route from its cluster to the target
+ *      tile, searching for the route first if no one has asked for it yet. Returns false without setting
+ *      the step when the target is close enough to head straight for, or there is no way to it.
+ */
+bool PathHierarchy::nextStep(const float x, const float y, const float targetX, const float targetY,
+        int& stepX, int& stepY) const {
+    int col;
+    int row;
+    int targetCol;
+    int targetRow;
+    if (!FlowField::tileAt(x, y, col, row) || !FlowField::tileAt(targetX, targetY, targetCol, targetRow)) {
+        return false;
+    }
+    //the same or a neighbouring tile, nothing to walk around
+    if (std::abs(targetCol - col) <= 1 && std::abs(targetRow - row) <= 1) {
+        return false;
+    }
+    const int cluster = clusterOf(col, row);
+    const auto route = routeFrom(cluster, targetCol, targetRow);
+    const uint8_t dir = (*route)[localIndex(boundsOf(cluster), col, row)];
+    if (dir == FlowField::NO_DIRECTION) {
+        return false;
+    }
+    stepX = (col + STEP_COL[dir]) * T_SIZE + T_SIZE / 2;
+    stepY = (row + STEP_ROW[dir]) * T_SIZE + T_SIZE / 2;
+    return true;
+}
+
+PathHierarchy::Bounds PathHierarchy::boundsOf(const int cluster) {
+    const int firstCol = (cluster % CLUSTER_COLS) * CLUSTER_SIZE;
+    const int firstRow = (cluster / CLUSTER_COLS) * CLUSTER_SIZE;
+    return {firstCol, firstRow, std::min(firstCol + CLUSTER_SIZE, M_WIDTH) - 1,
+        std::min(firstRow + CLUSTER_SIZE, M_HEIGHT) - 1};
+}
+
+bool PathHierarchy::open(const int col, const int row) const {
+    return col >= 0 && col < M_WIDTH && row >= 0 && row < M_HEIGHT && !walls[row][col];
+}
+
+/**
+ * Function Interface: void addEntrances(const int col, const int row, const int stepCol, const int stepRow,
+ *          const int length)
+ *      col : First tile of an open stretch of border, on the left or top side
+ *      row : First tile of an open stretch of border, on the left or top side
+ *      stepCol : Step along the border, 0 or 1
+ *      stepRow : Step along the border, 1 or 0
+ *      length : Tiles in the stretch
+ *
+ * Description:
+ *      Short stretches get an entrance in the middle, long ones one at each end so zombies aren't
+ *      all funnelled through the middle of a wide opening.
+ */
+void PathHierarchy::addEntrances(const int col, const int row, const int stepCol, const int stepRow,
+        const int length) {
+    //across the border is along the other axis
+    if (length < ENTRANCE_SPLIT) {
+        const int middle = length / 2;
+        addNode(col + middle * stepCol, row + middle * stepRow,
+            col + middle * stepCol + stepRow, row + middle * stepRow + stepCol);
+        return;
+    }
+    const int last = length - 1;
+    addNode(col, row, col + stepRow, row + stepCol);
+    addNode(col + last * stepCol, row + last * stepRow,
+        col + last * stepCol + stepRow, row + last * stepRow + stepCol);
+}
+
+// Adds the nodes on both sides of an entrance
+void PathHierarchy::addNode(const int col, const int row, const int otherCol, const int otherRow) {
+    const int first = nodes.size();
+    nodes.push_back({col, row, first + 1, {}});
+    nodes.push_back({otherCol, otherRow, first, {}});
+    clusterNodes[clusterOf(col, row)].push_back(first);
+    clusterNodes[clusterOf(otherCol, otherRow)].push_back(first + 1);
+}
+
+/**
+ * Function Interface: void searchCluster(const int cluster, const std::vector<Seed>& seeds,
+ *          std::array<int, CLUSTER_SIZE * CLUSTER_SIZE>& distance, ClusterRoute& direction) const
+ *      cluster : Cluster to search
+ *      seeds : Tiles of the cluster to start from, with their distance and direction
+ *      distance : Filled with the distance of each tile of the cluster from the nearest seed
+ *      direction : Filled with the direction of each tile towards the nearest seed, or the seed's own
+ *
+ * Description:
+ *      Same search as FlowField::build, kept inside the cluster.
+ */
+void PathHierarchy::searchCluster(const int cluster, const std::vector<Seed>& seeds,
+        std::array<int, CLUSTER_SIZE * CLUSTER_SIZE>& distance, ClusterRoute& direction) const {
+    const Bounds b = boundsOf(cluster);
+    const auto inside = [this, &b](const int col, const int row) {
+        return col >= b.firstCol && col <= b.lastCol && row >= b.firstRow && row <= b.lastRow && !walls[row][col];
+    };
+    distance.fill(FlowField::UNREACHABLE);
+    direction.fill(FlowField::NO_DIRECTION);
+
+    //min heap on distance of distance and local index
+    const auto later = std::greater<std::pair<int, int>>();
+    std::vector<std::pair<int, int>> frontier;
+    for (const Seed& s : seeds) {
+        const int i = localIndex(b, s.col, s.row);
+        if (inside(s.col, s.row) && s.cost < distance[i]) {
+            distance[i] = s.cost;
+            direction[i] = s.direction;
+            frontier.emplace_back(s.cost, i);
+        }
+    }
+    std::make_heap(frontier.begin(), frontier.end(), later);
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        const std::pair<int, int> tile = frontier.back();
+        frontier.pop_back();
+        if (tile.first > distance[tile.second]) {
+            continue;
+        }
+        const int col = b.firstCol + tile.second % CLUSTER_SIZE;
+        const int row = b.firstRow + tile.second / CLUSTER_SIZE;
+        for (int k = 0; k < FlowField::NO_DIRECTION; ++k) {
+            const int nextCol = col + STEP_COL[k];
+            const int nextRow = row + STEP_ROW[k];
+            if (!inside(nextCol, nextRow)) {
+                continue;
+            }
+            if (k >= FIRST_DIAGONAL && !(inside(nextCol, row) && inside(col, nextRow))) {
+                continue;
+            }
+            const int through = tile.first + (k >= FIRST_DIAGONAL ? DIAGONAL_COST : STRAIGHT_COST);
+            const int next = localIndex(b, nextCol, nextRow);
+            if (through < distance[next]) {
+                distance[next] = through;
+                direction[next] = k ^ 1;
+                frontier.emplace_back(through, next);
+                std::push_heap(frontier.begin(), frontier.end(), later);
+            }
+        }
+    }
+}
+
+/**
+ * Function Interface: std::shared_ptr<const TargetRoute> routeTo(const int col, const int row) const
+ *      col : Column of the target tile
+ *      row : Row of the target tile
+ *
+ * Description:
+ *      Distance to the target tile from every node. The target is joined to the nodes of its cluster
+ *      by searching the cluster from it, then Dijkstra runs over the nodes alone.
+ *      Zombies update on several threads at once, so the cache is only touched inside a critical
+ *      section. Two threads may both search for a missing route, the second one found is dropped.
+ */
+std::shared_ptr<const PathHierarchy::TargetRoute> PathHierarchy::routeTo(const int col, const int row) const {
+    const int key = row * M_WIDTH + col;
+    std::shared_ptr<const TargetRoute> cached;
+#pragma omp critical(pathCache)
+    {
+        const auto it = targetCache.find(key);
+        if (it != targetCache.end()) {
+            cached = it->second;
+        }
+    }
+    if (cached) {
+        return cached;
+    }
+
+    const auto route = std::make_shared<TargetRoute>();
+    route->distance.assign(nodes.size(), FlowField::UNREACHABLE);
+    route->crosses.assign(nodes.size(), false);
+
+    const int cluster = clusterOf(col, row);
+    const Bounds b = boundsOf(cluster);
+    std::array<int, CLUSTER_SIZE * CLUSTER_SIZE> distance;
+    ClusterRoute direction;
+    searchCluster(cluster, {{col, row, 0, FlowField::NO_DIRECTION}}, distance, direction);
+
+    const auto later = std::greater<std::pair<int, int>>();
+    std::vector<std::pair<int, int>> frontier;
+    for (const int n : clusterNodes[cluster]) {
+        const int cost = distance[localIndex(b, nodes[n].col, nodes[n].row)];
+        if (cost != FlowField::UNREACHABLE) {
+            route->distance[n] = cost;
+            frontier.emplace_back(cost, n);
+        }
+    }
+    std::make_heap(frontier.begin(), frontier.end(), later);
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        const std::pair<int, int> node = frontier.back();
+        frontier.pop_back();
+        if (node.first > route->distance[node.second]) {
+            continue;
+        }
+        const int partner = nodes[node.second].partner;
+        if (node.first + STRAIGHT_COST < route->distance[partner]) {
+            route->distance[partner] = node.first + STRAIGHT_COST;
+            route->crosses[partner] = true;
+            frontier.emplace_back(route->distance[partner], partner);
+            std::push_heap(frontier.begin(), frontier.end(), later);
+        }
+        for (const auto& edge : nodes[node.second].edges) {
+            if (node.first + edge.second < route->distance[edge.first]) {
+                route->distance[edge.first] = node.first + edge.second;
+                route->crosses[edge.first] = false;
+                frontier.emplace_back(route->distance[edge.first], edge.first);
+                std::push_heap(frontier.begin(), frontier.end(), later);
+            }
+        }
+    }
+
+#pragma omp critical(pathCache)
+    {
+        if (targetCache.size() >= PATH_CACHE_SIZE) {
+            targetCache.clear();
+        }
+        targetCache.emplace(key, route);
+    }
+    return route;
+}
+
+/**
+ * Function Interface: std::shared_ptr<const ClusterRoute> routeFrom(const int cluster, const int col,
+ *          const int row) const
+ *      cluster : Cluster to walk out of
+ *      col : Column of the target tile
+ *      row : Row of the target tile
+ *
+ * Description:
+ *      Direction towards the target tile from every tile of the cluster. The cluster is searched from
+ *      the nodes whose way to the target crosses their entrance, each starting at its distance to the
+ *      target and pointing across, and from the target itself if it is in the cluster.
+ */
+std::shared_ptr<const PathHierarchy::ClusterRoute> PathHierarchy::routeFrom(const int cluster, const int col,
+        const int row) const {
+    const int64_t key = static_cast<int64_t>(cluster) * M_WIDTH * M_HEIGHT + row * M_WIDTH + col;
+    std::shared_ptr<const ClusterRoute> cached;
+#pragma omp critical(pathCache)
+    {
+        const auto it = clusterCache.find(key);
+        if (it != clusterCache.end()) {
+            cached = it->second;
+        }
+    }
+    if (cached) {
+        return cached;
+    }
+
+    const auto target = routeTo(col, row);
+    std::vector<Seed> seeds;
+    if (clusterOf(col, row) == cluster) {
+        seeds.push_back({col, row, 0, FlowField::NO_DIRECTION});
+    }
+    for (const int n : clusterNodes[cluster]) {
+        if (target->crosses[n]) {
+            const Node& across = nodes[nodes[n].partner];
+            seeds.push_back({nodes[n].col, nodes[n].row, target->distance[n],
+                directionOf(across.col - nodes[n].col, across.row - nodes[n].row)});
+        }
+    }
+    const auto route = std::make_shared<ClusterRoute>();
+    std::array<int, CLUSTER_SIZE * CLUSTER_SIZE> distance;
+    searchCluster(cluster, seeds, distance, *route);
+
+#pragma omp critical(pathCache)
+    {
+        if (clusterCache.size() >= PATH_CACHE_SIZE) {
+            clusterCache.clear();
+        }
+        clusterCache.emplace(key, route);
+    }
+    return route;
+}
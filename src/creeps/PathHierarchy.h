@@ -0,0 +1,124 @@
+/*------------------------------------------------------------------------------
+* Header: PathHierarchy.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Paths towards any tile, for zombies chasing a marine or turret around the walls.
+*       The AI map is split into clusters of CLUSTER_SIZE tiles a side. Wherever two clusters share
+*       an open border there is an entrance, a node on each side of it, and the nodes in a cluster are
+*       joined by the shortest paths between them inside it. All of that is built once with the map.
+*       Finding a way to a target then only searches the nodes, not the tiles. The search from a
+*       target tile is kept, along with a direction for every tile of each cluster it is asked about,
+*       so every zombie chasing the same marine from the same cluster shares one lookup.
+*       Both are kept until PATH_CACHE_SIZE of them have been made, then thrown out together.
+*       Steps are found on the walls of the AI map only, placed barricades and turrets are slid around.
+*
+------------------------------------------------------------------------------*/
+#ifndef PATHHIERARCHY_H
+#define PATHHIERARCHY_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+#include "FlowField.h"
+
+//tiles along each side of a cluster
+static constexpr int CLUSTER_SIZE = 10;
+static constexpr int CLUSTER_COLS = (M_WIDTH + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+static constexpr int CLUSTER_ROWS = (M_HEIGHT + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+//open borders at least this long get an entrance at each end instead of one in the middle
+static constexpr int ENTRANCE_SPLIT = 6;
+//searches kept before they are all thrown out
+static constexpr unsigned int PATH_CACHE_SIZE = 256;
+
+class PathHierarchy {
+public:
+    PathHierarchy() = default;
+    ~PathHierarchy() = default;
+
+    // Finds the entrances between clusters and the paths between them, throwing out anything cached
+    void build(const AiGrid& walls);
+
+    // Middle of the tile to walk to next from the first point on the way to the second, false if they
+    // are on the same or neighbouring tiles, either is off the map, or there is no way there
+    bool nextStep(const float x, const float y, const float targetX, const float targetY,
+        int& stepX, int& stepY) const;
+
+    unsigned int getNodeCount() const {return nodes.size();}
+
+private:
+    //tile on one side of an entrance
+    struct Node {
+        int col;
+        int row;
+        int partner; //node on the other side of the entrance
+        std::vector<std::pair<int, int>> edges; //other nodes of the cluster and the cost of getting to them
+    };
+
+    //distance from every node to a target tile, and whether the node's way there crosses its entrance
+    struct TargetRoute {
+        std::vector<int> distance;
+        std::vector<bool> crosses;
+    };
+
+    //direction towards the target from every tile of a cluster, as FlowField directions
+    typedef std::array<uint8_t, CLUSTER_SIZE * CLUSTER_SIZE> ClusterRoute;
+
+    //tile a search starts from, with what it costs to get there and its direction
+    struct Seed {
+        int col;
+        int row;
+        int cost;
+        uint8_t direction;
+    };
+
+    //bounds of a cluster in tiles, last ones included
+    struct Bounds {
+        int firstCol;
+        int firstRow;
+        int lastCol;
+        int lastRow;
+    };
+
+    static int clusterOf(const int col, const int row) {
+        return (row / CLUSTER_SIZE) * CLUSTER_COLS + col / CLUSTER_SIZE;
+    }
+    static Bounds boundsOf(const int cluster);
+    static int localIndex(const Bounds& b, const int col, const int row) {
+        return (row - b.firstRow) * CLUSTER_SIZE + col - b.firstCol;
+    }
+
+    bool open(const int col, const int row) const;
+    void addEntrances(const int col, const int row, const int stepCol, const int stepRow, const int length);
+    void addNode(const int col, const int row, const int otherCol, const int otherRow);
+
+    // Dijkstra inside one cluster from the seeds, filling distance and direction for each of its tiles
+    void searchCluster(const int cluster, const std::vector<Seed>& seeds,
+        std::array<int, CLUSTER_SIZE * CLUSTER_SIZE>& distance, ClusterRoute& direction) const;
+
+    std::shared_ptr<const TargetRoute> routeTo(const int col, const int row) const;
+    std::shared_ptr<const ClusterRoute> routeFrom(const int cluster, const int col, const int row) const;
+
+    AiGrid walls{};
+    std::vector<Node> nodes;
+    std::array<std::vector<int>, CLUSTER_COLS * CLUSTER_ROWS> clusterNodes;
+
+    //searches made so far, by target tile as row * M_WIDTH + col, and by cluster and target tile
+    mutable std::unordered_map<int, std::shared_ptr<const TargetRoute>> targetCache;
+    mutable std::unordered_map<int64_t, std::shared_ptr<const ClusterRoute>> clusterCache;
+};
+
+#endif
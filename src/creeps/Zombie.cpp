@@ -24,7 +24,6 @@
 #include "../game/GameManager.h"
 #include "../log/log.h"
 #include "../sprites/VisualEffect.h"
-#include "../inventory/weapons/ZombieHand.h"
 #include <cstdlib>
 using namespace std;
 
@@ -32,12 +31,15 @@ using namespace std;
  * Author: Robert Arendac
  *
  * Date: April 6, 2017
+ *
+ * Description:
+ *      Takes the hands of a dead zombie when there are any, otherwise registers new ones with the
+ *      weapon manager.
  */
 Zombie::Zombie(const int32_t id, const SDL_Rect& dest, const SDL_Rect& movementSize, const SDL_Rect& projectileSize,
         const SDL_Rect& damageSize, const int health) : Entity(id, dest, movementSize, projectileSize,
         damageSize), Movable(id, dest, movementSize, projectileSize, damageSize, ZOMBIE_VELOCITY), health(health),
-        frameCount(0), ignore(0), flipper(1), actionTick(0), action('\0') {
-    inventory.initZombie();
+        frameCount(0), actionTick(0), action('\0'), weaponId(GameManager::instance()->takeZombieHand()) {
 }
 
 /**
@@ -51,143 +53,105 @@ Zombie::~Zombie() {
  * Author: Isaac Morneau
  *
  * Date: April 6, 2017
+ *
+ * Description:
+ *      Decides where the zombie heads, run whenever the AI scheduler gets to it. The closest marine or
+ *      turret in sight, found for every zombie at once by GameManager::updateZombies, is chased around
+ *      the walls, otherwise the zombie follows the flow field to the base. Attacks if the target is in range.
  */
-void Zombie::update(){
-    ++frameCount;
+void Zombie::think(const ZombieTarget& target) {
     //middle of me
     const int midMeX = getX() + (getW() / 2);
     const int midMeY = getY() + (getH() / 2);
-    const Entity visSection(0, {midMeX - ZOMBIE_SIGHT, midMeY - ZOMBIE_SIGHT,
-        2 * ZOMBIE_SIGHT, 2 * ZOMBIE_SIGHT});
-
-    if (!(frameCount % ANGLE_UPDATE_RATE)) {
-        //Movement updates
-        GameManager *gm = GameManager::instance();
-        const auto& base = gm->getBase();
-        auto& collision = gm->getCollisionHandler();
-        const auto& marines = collision.getQuadTreeEntities(collision.getMarineTree(), &visSection);
-        const auto& turrrets = collision.getQuadTreeEntities(collision.getTurretTree(), &visSection);
-
-        //the difference in zombie to target distance
-        float movX;
-        float movY;
-
-        //middle of the base
-        const int midBaseX = base.getX() + (base.getW() / 2);
-        const int midBaseY = base.getY() + (base.getH() / 2);
-
-        //temp x and y for calculating the hypot
-        int hypX;
-        int hypY;
 
-        //hypo variables
-        float hyp = ZOMBIE_SIGHT;
-        float temp;
+    //Movement updates
+    GameManager *gm = GameManager::instance();
+    const auto& base = gm->getBase();
 
-        //who is closest?
-        for (const auto m : marines){
-            hypX = m->getX() + (m->getW() / 2);
-            hypY = m->getY() + (m->getH() / 2);
+    //middle of the base
+    const int midBaseX = base.getX() + (base.getW() / 2);
+    const int midBaseY = base.getY() + (base.getH() / 2);
 
-            //we only want the closest one
-            if((temp = hypot(hypX - midMeX, hypY - midMeY)) < hyp){
-                hyp = temp;
-                movX = hypX - midMeX;
-                movY = hypY - midMeY;
-            }
-        }
-        for (const auto t : turrrets){
-            hypX = t->getX() + (t->getW() / 2);
-            hypY = t->getY() + (t->getH() / 2);
+    //how far the closest target is, ZOMBIE_SIGHT if there is none
+    const float hyp = target.distance;
 
-            //we only want the closest one
-            if((temp = hypot(hypX - midMeX, hypY - midMeY)) < hyp){
-                hyp = temp;
-                movX = hypX - midMeX;
-                movY = hypY - midMeY;
-            }
-        }
+    //the difference in zombie to target distance
+    float movX = target.x - midMeX;
+    float movY = target.y - midMeY;
 
-        //only change the angle a max of 4 times a second and its not being ignored
-        if (!ignore) {
-            //if no one was close lets go get the base!
-            if (hyp >= ZOMBIE_SIGHT) {
-                movX = midBaseX - midMeX;
-                movY = midBaseY - midMeY;
-            }
-            //-1 converts from cartisian to screen coords
-            setRadianAngle(fmod(atan2(movX, movY) + 2 * M_PI, 2 * M_PI));
+    //if no one was close lets go get the base!
+    //the flow field leads around the walls, once it runs out the base is in the next tile
+    int stepX;
+    int stepY;
+    if (hyp >= ZOMBIE_SIGHT && gm->getBaseFlow().nextStep(midMeX, midMeY, stepX, stepY)) {
+        movX = stepX - midMeX;
+        movY = stepY - midMeY;
+    } else if (hyp < ZOMBIE_SIGHT && gm->getChasePaths().nextStep(midMeX, midMeY, target.x, target.y,
+            stepX, stepY)) {
+        //a target a tile or more away may be behind a wall
+        movX = stepX - midMeX;
+        movY = stepY - midMeY;
+    } else if (hyp >= ZOMBIE_SIGHT) {
+        movX = midBaseX - midMeX;
+        movY = midBaseY - midMeY;
+    }
+    //-1 converts from cartisian to screen coords
+    setRadianAngle(fmod(atan2(movX, movY) + 2 * M_PI, 2 * M_PI));
 
-            //we only attack if we are actually in range
-            if (hyp <= ZombieHandVars::RANGE) {
-                zAttack();
-            }
-        } else if (ignore > 0){
-            --ignore;
-        }
+    //we only attack if we are actually in range
+    if (hyp <= ZombieHandVars::RANGE) {
+        zAttack();
     }
-    //get the distance of
-    setDX(ZOMBIE_VELOCITY * sin(getRadianAngle()));
-    setDY(ZOMBIE_VELOCITY * cos(getRadianAngle()));
+}
+
+/**
+ * Function Interface: void update()
+ *
+ * Description:
+ *      Moves the animation on a frame. GameManager::updateZombies sets the velocity from the angle the
+ *      zombie last decided on.
+ */
+void Zombie::update() {
+    ++frameCount;
 }
 
 /**
  * Author: Isaac Morneau
  *
  * Date: April 6, 2017
+ *
+ * Description:
+ *      Sweeps the move against everything that blocks zombies, sliding along what it hits.
  */
 void Zombie::move(const float moveX, const float moveY, CollisionHandler& ch) {
-    static constexpr int IGNORE_TIME = 5;
-    static constexpr int PARTIAL_ROTATION = 63;
-    bool hasFlipped = false;
-    //Move the Movable left or right
-    setX(getX() + moveX);
-
-    //if there is a collision with anything with a movement hitbox, move it back
-    if (ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieMovementTree(),this),this)) {
-        setX(getX() - moveX);
-        //we are avoiding but its not working so flip
-        if(ignore == IGNORE_TIME -1){
-            hasFlipped = true;
-            flipper *= -1;
-        //we are not currently avoiding, start
-        } else if (!ignore) {
-            ignore = IGNORE_TIME;
-        }
-        setAngle(getAngle() + (flipper * PARTIAL_ROTATION));
-    }
-
-    //Move the Movable up or down
-    setY(getY()+moveY);
-
-    //if there is a collision with anything with a movement hitbox, move it back
-    if (ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieMovementTree(),this),this)) {
-        setY(getY() - moveY);
-        //we are avoiding but its not working so flip
-        if(ignore == IGNORE_TIME -1 && !hasFlipped){
-            flipper *= -1;
-        //we are not currently avoiding, start
-        } else if (!ignore) {
-            ignore = IGNORE_TIME;
-        }
-        setAngle(getAngle() + (flipper * PARTIAL_ROTATION));
-    }
+    const auto pos = ch.sweepMovement(this, moveX, moveY, CollisionCategory::ZOMBIE_BLOCKERS);
+    setPosition(pos.first, pos.second);
 }
 
 /**
  * Author: Mark Tattrie
  *
  * Date: April 6, 2017
+ *
+ * Description:
+ *      Only the hit that kills the zombie handles its death, and the deletion waits for the end of the tick.
  */
 void Zombie::collidingProjectile(int damage) {
-    health -= damage;
-    if (health <= 0) {
+    //shots from several threads can land at once, the health left after each one tells them apart
+    int left;
+#pragma omp atomic capture
+    left = health -= damage;
+    if (left <= 0) {
+        if (left + damage <= 0) {
+            //already dead, waiting to be deleted
+            return;
+        }
         GameManager::instance()->getPlayer().addCredits();
 
 #ifndef SERVER
         VisualEffect::instance().addBody(getDestRect(),getId());
 #endif
-        GameManager::instance()->deleteZombie(getId());
+        GameManager::instance()->queueDeletion(UDPHeaders::ZOMBIE, getId());
 #ifndef SERVER
     } else {
         VisualEffect::instance().addBlood(getDestRect());
@@ -207,7 +171,7 @@ void Zombie::collidingProjectile(int damage) {
  * Calls the zombies current weapon "ZombieHands" to fire
  */
 void Zombie::zAttack(){
-    Weapon* w = inventory.getCurrent();
+    const auto w = GameManager::instance()->getWeapon(weaponId);
     if (w){
         w->fire(*this);
         //should only add a new animation if a different one isnt playing
@@ -29,7 +29,6 @@
 #include "../collision/HitBox.h"
 #include "../basic/Entity.h"
 #include "../collision/CollisionHandler.h"
-#include "../inventory/Inventory.h"
 #include "../collision/Quadtree.h"
 #include "../buildings/Base.h"
 #include "../view/Window.h"
@@ -44,7 +43,7 @@ static constexpr int ZOMBIE_WIDTH = 75; // x value
 static constexpr int ZOMBIE_DEAD_WIDTH = 122; // dead zombie x value
 static constexpr int FRAME_COUNT_ZOMBIE = 10; // speed of walking animation
 static constexpr int CHECK_RATE = 15; // 60 / 4 times 
-static constexpr int ANGLE_UPDATE_RATE = 5;
+static constexpr int ANGLE_UPDATE_RATE = 5; //frames between a zombie's decisions, on average
 static constexpr int ATTACK_DURATION = 10;
 static constexpr int HIT_DURATION = 15;
 
@@ -74,6 +73,13 @@ static constexpr double ZOMBIE_SPRITE_ANGLE7 = 11 * M_PI / 8;
 static constexpr double ZOMBIE_SPRITE_ANGLE8 = 13 * M_PI / 8;
 static constexpr double ZOMBIE_SPRITE_ANGLE9 = 2 * M_PI;
 
+//closest marine or turret to a zombie, found for every zombie at once each tick
+struct ZombieTarget {
+    float distance; //ZOMBIE_SIGHT if there is nothing in sight
+    int x; //middle of the target
+    int y;
+};
+
 class Zombie : public Movable {
 public:
     Zombie(const int32_t id, const SDL_Rect& dest, const SDL_Rect& movementSize, const SDL_Rect& projectileSize,
@@ -86,20 +92,20 @@ public:
     void collidingProjectile(int damage);
 
     int getHealth() const {return health;}
+    int32_t getWeaponId() const {return weaponId;}
     void setHealth(const int h) {health = h;}
 
-    void update();
+    void think(const ZombieTarget& target); // Decides where to go and whether to attack
+    void update(); // Walks on in the direction decided, every frame
     void updateImageWalk();
     void updateImageDirection();
 
 private:
     int health;// health points of zombie
     int frameCount;//counts frames for animation
-    int ignore;//how long to not track for
-    int flipper;//do we need to go the other way?
     int actionTick;//when the action started
     char action;
-    Inventory inventory;//inventory holds a weapon used to attack
+    int32_t weaponId;//hands used to attack, kept in the weapon manager
     void zAttack();//ATTACK!
 };
 
@@ -0,0 +1,129 @@
+/*------------------------------------------------------------------------------
+* Header: ZombieComponents.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       The fields the per tick zombie update reads and writes, position, velocity, angle and movement
+*       hitbox, kept in parallel arrays indexed by the slot of each zombie's handle in the zombie manager.
+*       The extent the collision grid files each zombie under is kept alongside.
+*       GameManager::updateCollider copies them out of every zombie at the start of a tick and refreshes
+*       the grid from them, updateZombies moves the zombies in the arrays and writes the position and
+*       velocity back into each zombie once, and the server snapshot reads them.
+*       Each slot keeps the handle it was copied for, so a slot reused by a new zombie since the copy
+*       is never mistaken for it. The hitboxes and extents are as of the copy.
+*
+------------------------------------------------------------------------------*/
+#ifndef ZOMBIECOMPONENTS_H
+#define ZOMBIECOMPONENTS_H
+#include <SDL2/SDL.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "Zombie.h"
+#include "../collision/HitBox.h"
+#include "../collision/Quadtree.h"
+#include "../game/SlotMap.h"
+
+struct ZombieComponents {
+    typedef SlotMap<int32_t, Zombie>::Handle Handle;
+
+    //handle each slot was copied for, NULL_HANDLE once the slot is emptied
+    std::vector<Handle> handles;
+    //the zombie in each slot, as a zombie and as what the collision grid takes, nullptr for empty slots
+    std::vector<Zombie *> zombies;
+    std::vector<Entity *> entities;
+    std::vector<int32_t> ids;
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> dxs;
+    std::vector<float> dys;
+    //degrees, as Movable keeps them
+    std::vector<float> angles;
+    std::vector<HitBox> moveBoxes;
+    std::vector<SDL_Rect> extents;
+
+    unsigned int size() const {return handles.size();}
+
+    // Returns true if the slot holds a copy made for the handle
+    bool holds(const Handle handle) const {
+        const uint32_t slot = handle & SlotMap<int32_t, Zombie>::INDEX_MASK;
+        return slot < handles.size() && handles[slot] == handle;
+    }
+
+    // Grows the arrays to at least the number of slots, keeping what is in them
+    void resize(const unsigned int slots) {
+        if (slots <= handles.size()) {
+            return;
+        }
+        handles.resize(slots, Handle(SlotMap<int32_t, Zombie>::NULL_HANDLE));
+        zombies.resize(slots, nullptr);
+        entities.resize(slots, nullptr);
+        ids.resize(slots);
+        xs.resize(slots);
+        ys.resize(slots);
+        dxs.resize(slots);
+        dys.resize(slots);
+        angles.resize(slots);
+        moveBoxes.resize(slots, HitBox({0, 0, 0, 0}));
+        extents.resize(slots);
+    }
+
+    // Makes room for n slots so copying up to that many zombies never allocates
+    void reserve(const unsigned int n) {
+        handles.reserve(n);
+        zombies.reserve(n);
+        entities.reserve(n);
+        ids.reserve(n);
+        xs.reserve(n);
+        ys.reserve(n);
+        dxs.reserve(n);
+        dys.reserve(n);
+        angles.reserve(n);
+        moveBoxes.reserve(n);
+        extents.reserve(n);
+    }
+
+    // Empties every slot, keeping the storage
+    void clear() {
+        std::fill(handles.begin(), handles.end(), Handle(SlotMap<int32_t, Zombie>::NULL_HANDLE));
+        std::fill(zombies.begin(), zombies.end(), nullptr);
+        std::fill(entities.begin(), entities.end(), nullptr);
+    }
+
+    // Copies the hot fields of a zombie into the slot of its handle, which must be in the arrays
+    void load(const Handle handle, Zombie& zombie) {
+        const uint32_t slot = handle & SlotMap<int32_t, Zombie>::INDEX_MASK;
+        handles[slot] = handle;
+        zombies[slot] = &zombie;
+        entities[slot] = &zombie;
+        ids[slot] = zombie.getId();
+        xs[slot] = zombie.getX();
+        ys[slot] = zombie.getY();
+        dxs[slot] = zombie.getDX();
+        dys[slot] = zombie.getDY();
+        angles[slot] = zombie.getAngle();
+        moveBoxes[slot] = zombie.getMoveHitBox();
+        extents[slot] = Quadtree::getExtent(&zombie);
+    }
+
+    // Writes the position and velocity in a slot back into its zombie
+    void store(const uint32_t slot) const {
+        Zombie& zombie = *zombies[slot];
+        zombie.setPosition(xs[slot], ys[slot]);
+        zombie.setDX(dxs[slot]);
+        zombie.setDY(dys[slot]);
+    }
+};
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef FLATMAP_H
+#define FLATMAP_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Hash table kept in one flat array, used where keys are looked up every frame and come and go
+ * all the time, like the handles of a SlotMap or the cells of the spatial grid.
+ * Unlike an unordered_map there is no node per key, so once the table has been reserved for as
+ * many keys as it will hold, inserting and erasing never allocate.
+ * Collisions probe the next bucket along, and erasing shifts the rest of the run back into the
+ * gap, so lookups never have to step over erased keys.
+ * Keys and values must be default constructible and copyable, ids and pointers are what it is for.
+ * Pointers returned by get() and insert() stay valid until the table grows, which only happens
+ * on an insert past what was reserved.
+ */
+template<typename K, typename V>
+class FlatMap {
+public:
+    FlatMap() = default;
+    ~FlatMap() = default;
+
+    /*
+     * Returns the value of the key, or nullptr if there isn't one.
+     */
+    V *get(const K& key) {
+        if (!count) {
+            return nullptr;
+        }
+        for (std::size_t i = home(key);; i = next(i)) {
+            Bucket& bucket = buckets[i];
+            if (!bucket.used) {
+                return nullptr;
+            }
+            if (bucket.key == key) {
+                return &bucket.value;
+            }
+        }
+    }
+
+    const V *get(const K& key) const {
+        return const_cast<FlatMap *>(this)->get(key);
+    }
+
+    /*
+     * Inserts the key with the value, or assigns the value if the key is already in the table.
+     * Returns the stored value.
+     */
+    V& insert(const K& key, const V& value) {
+        if (V *found = get(key)) {
+            *found = value;
+            return *found;
+        }
+        if ((count + 1) * 2 > buckets.size()) {
+            grow(count + 1);
+        }
+        std::size_t i = home(key);
+        while (buckets[i].used) {
+            i = next(i);
+        }
+        buckets[i] = {key, value, true};
+        ++count;
+        return buckets[i].value;
+    }
+
+    /*
+     * Removes the key, returning false if it wasn't in the table.
+     */
+    bool erase(const K& key) {
+        if (!count) {
+            return false;
+        }
+        std::size_t gap = home(key);
+        while (!(buckets[gap].used && buckets[gap].key == key)) {
+            if (!buckets[gap].used) {
+                return false;
+            }
+            gap = next(gap);
+        }
+        //move back every later key in the run that would otherwise be cut off from its home bucket
+        for (std::size_t i = next(gap); buckets[i].used; i = next(i)) {
+            const std::size_t want = home(buckets[i].key);
+            if (((i - want) & mask()) >= ((i - gap) & mask())) {
+                buckets[gap] = buckets[i];
+                gap = i;
+            }
+        }
+        buckets[gap].used = false;
+        --count;
+        return true;
+    }
+
+    /*
+     * Makes room for n keys so inserting up to that many never allocates.
+     */
+    void reserve(const std::size_t n) {
+        if (n * 2 > buckets.size()) {
+            grow(n);
+        }
+    }
+
+    //empties the table, keeping its buckets
+    void clear() {
+        for (Bucket& bucket : buckets) {
+            bucket.used = false;
+        }
+        count = 0;
+    }
+
+    void swap(FlatMap& other) {
+        std::swap(buckets, other.buckets);
+        std::swap(count, other.count);
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return !count;
+    }
+
+    bool contains(const K& key) const {
+        return get(key) != nullptr;
+    }
+
+private:
+    struct Bucket {
+        K key;
+        V value;
+        bool used;
+    };
+
+    std::size_t mask() const {
+        return buckets.size() - 1;
+    }
+
+    std::size_t next(const std::size_t i) const {
+        return (i + 1) & mask();
+    }
+
+    //ids and pointers hash to themselves, so the hash is mixed before it picks a bucket
+    std::size_t home(const K& key) const {
+        return (static_cast<uint64_t>(std::hash<K>()(key)) * 0x9E3779B97F4A7C15ull >> 32) & mask();
+    }
+
+    //rebuilds the table at the smallest power of two holding n keys at most half full
+    void grow(const std::size_t n) {
+        std::size_t size = 16;
+        while (size < n * 2) {
+            size *= 2;
+        }
+        std::vector<Bucket> old(size, Bucket{K(), V(), false});
+        old.swap(buckets);
+        count = 0;
+        for (const Bucket& bucket : old) {
+            if (bucket.used) {
+                std::size_t i = home(bucket.key);
+                while (buckets[i].used) {
+                    i = next(i);
+                }
+                buckets[i] = bucket;
+                ++count;
+            }
+        }
+    }
+
+    std::vector<Bucket> buckets;
+    std::size_t count = 0;
+};
+
+#endif
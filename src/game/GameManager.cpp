@@ -3,6 +3,8 @@
 #include <utility>
 #include <atomic>
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 
 #include "../collision/HitBox.h"
 #include "../log/log.h"
@@ -12,12 +14,14 @@
 #include "../server/servergamestate.h"
 #include "../buildings/TechStore.h"
 #include "../buildings/HealthStore.h"
-Weapon w;
+#include "../inventory/weapons/ZombieHand.h"
 GameManager GameManager::sInstance;
-//Returns the already existing GameManager or if there isn't one, makes
-//a new one and returns it.
+thread_local GameManager *GameManager::current = nullptr;
+thread_local bool GameManager::updateTeam = false;
+
+//Returns the world bound to the calling thread by a WorldScope, or the default one.
 GameManager *GameManager::instance() {
-    return &GameManager::sInstance;
+    return current ? current : &GameManager::sInstance;
 }
 
 int32_t GameManager::generateID() {
@@ -33,7 +37,7 @@ int32_t GameManager::generateID() {
  * Description:
  *     ctor for the game manager.
  */
-GameManager::GameManager() : collisionHandler() {
+GameManager::GameManager() : collisionHandler(), queuedDeletions(omp_get_max_threads()) {
     logv("Create GM\n");
 }
 
@@ -191,7 +195,6 @@ void GameManager::updateStores(){
 }
 /**
  * Date: Feb. 4, 2017
- * Modified: ----
  * Author: Jacob McPhail
  * Function Interface: (const float delta)
  *      delta : Delta time to control frame rate.
@@ -206,6 +209,7 @@ void GameManager::updateMarines(const float delta) {
         for (auto it = marineManager.begin(); it != marineManager.end(); ++it) {
 #pragma omp task firstprivate(it)
             {
+                const WorldScope world(this, true);
                 if (!networked) {
                     it->second.move((it->second.getDX() * delta), (it->second.getDY() * delta), collisionHandler);
                 }
@@ -219,23 +223,194 @@ void GameManager::updateMarines(const float delta) {
     }
 }
 
-// Update zombie movements.
+/**
+ * Function Interface: void GameManager::updateZombies(const float delta)
+ *      delta : Delta time to control frame rate.
+ *
+ * Description:
+ *     Update zombie movements.
+ *     Runs on the hot fields updateCollider copied out of the zombies, picking up any zombie made since.
+ *     The slots of the zombies are gathered into one array and split across threads in chunks. The closest
+ *     target of every zombie the scheduler picks is found in one pass, then those zombies decide and every
+ *     zombie moves in the arrays, its position and velocity written back into it once it has.
+ *     AI_TICK_BUDGET runs from the start, so gathering, scheduling and the target search all count
+ *     against it, and zombies past the first chunk stop deciding once it is spent. The update and move
+ *     pass after it is not bounded, every zombie has to move every tick.
+ */
 void GameManager::updateZombies(const float delta) {
+    const double deadline = omp_get_wtime() + AI_TICK_BUDGET / 1e6;
+    zombieHot.resize(zombieManager.slotCount());
+    zombieSlots.clear();
+    for (auto it = zombieManager.begin(); it != zombieManager.end(); ++it) {
+        const auto handle = it.handle();
+        if (!zombieHot.holds(handle)) {
+            zombieHot.load(handle, it->second);
+        }
+        zombieSlots.push_back(handle & SlotMap<int32_t, Zombie>::INDEX_MASK);
+    }
+
+    scheduleThinkers();
+    findZombieTargets();
+
 #pragma omp parallel
-#pragma omp single
     {
-        for (auto it = zombieManager.begin(); it != zombieManager.end(); ++it) {
-#pragma omp task firstprivate(it)
-            {
-                it->second.update();
-                it->second.move((it->second.getDX() * delta), (it->second.getDY() * delta), collisionHandler);
+        const WorldScope world(this, true);
+#pragma omp for schedule(dynamic, ZOMBIE_UPDATE_CHUNK)
+        for (unsigned int i = 0; i < zombieThinkers.size(); ++i) {
+            //the first chunk always decides so the scheduler can't stall
+            if (i >= static_cast<unsigned int>(ZOMBIE_UPDATE_CHUNK) && omp_get_wtime() > deadline) {
+                continue;
+            }
+            const unsigned int slot = zombieThinkers[i];
+            Zombie& zombie = *zombieHot.zombies[slot];
+            const int t = nearestTargets[i];
+            if (t < 0) {
+                zombie.think({ZOMBIE_SIGHT, 0, 0});
+            } else {
+                zombie.think({std::sqrt(nearestDistances[i]), static_cast<int>(targetXs[t]),
+                    static_cast<int>(targetYs[t])});
+            }
+            zombieHot.angles[slot] = zombie.getAngle();
+            zombieThought[i] = 1;
+        }
+
+#pragma omp for schedule(dynamic, ZOMBIE_UPDATE_CHUNK)
+        for (unsigned int i = 0; i < zombieSlots.size(); ++i) {
+            const unsigned int slot = zombieSlots[i];
+            Zombie& zombie = *zombieHot.zombies[slot];
+            zombie.update();
+            const float radians = zombieHot.angles[slot] * M_PI / 180;
+            zombieHot.dxs[slot] = ZOMBIE_VELOCITY * std::sin(radians);
+            zombieHot.dys[slot] = ZOMBIE_VELOCITY * std::cos(radians);
+            const auto pos = collisionHandler.sweepMovement(&zombie, zombieHot.moveBoxes[slot], zombieHot.xs[slot],
+                zombieHot.ys[slot], zombieHot.dxs[slot] * delta, zombieHot.dys[slot] * delta,
+                CollisionCategory::ZOMBIE_BLOCKERS);
+            zombieHot.xs[slot] = pos.first;
+            zombieHot.ys[slot] = pos.second;
+            zombieHot.store(slot);
 #ifndef SERVER
-                it->second.updateImageDirection();
-                it->second.updateImageWalk();
+            zombie.updateImageDirection();
+            zombie.updateImageWalk();
 #endif
-            }
         }
-#pragma omp taskwait
+    }
+    finishThinking();
+}
+
+/**
+ * Function Interface: void GameManager::scheduleThinkers()
+ *
+ * Description:
+ *     Takes the next share of the zombies by id, starting from the first one at or after the cursor
+ *     and wrapping around, as the zombies to decide this tick. Each zombie decides once every
+ *     ANGLE_UPDATE_RATE ticks, so the share is that fraction of them plus the backlog from the last tick.
+ *     Going round by id instead of by each zombie's own frame count spreads the decisions evenly over
+ *     the ticks, even for zombies spawned together, and unlike a place in the batch an id doesn't move
+ *     when the manager reorders its zombies, so none are skipped or decide twice in a round.
+ */
+void GameManager::scheduleThinkers() {
+    zombieThinkers.clear();
+    zombieXs.clear();
+    zombieYs.clear();
+    const unsigned int count = zombieSlots.size();
+    if (!count) {
+        zombieThought.clear();
+        return;
+    }
+    const std::vector<int32_t>& ids = zombieHot.ids;
+    std::sort(zombieSlots.begin(), zombieSlots.end(), [&ids](const unsigned int a, const unsigned int b) {
+        return ids[a] < ids[b];
+    });
+    const unsigned int start = std::lower_bound(zombieSlots.begin(), zombieSlots.end(), aiCursor,
+        [&ids](const unsigned int slot, const int32_t id) {
+            return ids[slot] < id;
+        }) - zombieSlots.begin();
+    const unsigned int due = std::min(count, (count + ANGLE_UPDATE_RATE - 1) / ANGLE_UPDATE_RATE + aiBacklog);
+    //where the cursor goes if every zombie due gets to decide
+    aiNextRound = ids[zombieSlots[(start + due) % count]];
+    for (unsigned int i = 0; i < due; ++i) {
+        const unsigned int slot = zombieSlots[(start + i) % count];
+        zombieThinkers.push_back(slot);
+        //zombies are made with a movement hitbox the size of their sprite, so this is the middle they steer from
+        const SDL_Rect& box = zombieHot.moveBoxes[slot].getRect();
+        zombieXs.push_back(box.x + box.w / 2);
+        zombieYs.push_back(box.y + box.h / 2);
+    }
+    zombieThought.assign(due, 0);
+}
+
+/**
+ * Function Interface: void GameManager::finishThinking()
+ *
+ * Description:
+ *     Moves the cursor to the id of the first zombie that ran out of time, or past every zombie due.
+ *     Everything from there on is the backlog and goes first next tick. Threads take their chunks
+ *     in order, so the few past that point that did decide will only decide again a tick early.
+ *     Logs when the scheduler falls behind and when it catches up.
+ */
+void GameManager::finishThinking() {
+    unsigned int done = 0;
+    while (done < zombieThought.size() && zombieThought[done]) {
+        ++done;
+    }
+    const unsigned int behind = zombieThought.size() - done;
+    if (behind && !aiBacklog) {
+        logv("Zombie AI is over budget, %u decisions carried to the next tick\n", behind);
+    } else if (!behind && aiBacklog) {
+        logv("Zombie AI caught up\n");
+    }
+    aiBacklog = behind;
+    if (!zombieThinkers.empty()) {
+        aiCursor = behind ? zombieHot.ids[zombieThinkers[done]] : aiNextRound;
+    }
+}
+
+/**
+ * Function Interface: void GameManager::findZombieTargets()
+ *
+ * Description:
+ *     Finds the closest marine or placed turret within ZOMBIE_SIGHT of every zombie deciding this tick,
+ *     filling nearestTargets with its index in targetXs and targetYs, or -1 if nothing is in sight,
+ *     and nearestDistances with its squared distance.
+ *     There are only ever a handful of targets against hundreds of zombies, so each target is
+ *     checked against every zombie in turn instead of searching the collision index per zombie.
+ *     The inner loop over the zombies is branch free and vectorized.
+ */
+void GameManager::findZombieTargets() {
+    targetXs.clear();
+    targetYs.clear();
+    for (const auto& m : marineManager) {
+        targetXs.push_back(static_cast<int>(m.second.getX() + m.second.getW() / 2));
+        targetYs.push_back(static_cast<int>(m.second.getY() + m.second.getH() / 2));
+    }
+    for (const auto& t : turretManager) {
+        if (t.second.isPlaced()) {
+            targetXs.push_back(static_cast<int>(t.second.getX() + t.second.getW() / 2));
+            targetYs.push_back(static_cast<int>(t.second.getY() + t.second.getH() / 2));
+        }
+    }
+
+    const int count = zombieThinkers.size();
+    nearestDistances.assign(count, static_cast<float>(ZOMBIE_SIGHT) * ZOMBIE_SIGHT);
+    nearestTargets.assign(count, -1);
+    const float *const xs = zombieXs.data();
+    const float *const ys = zombieYs.data();
+    float *const distances = nearestDistances.data();
+    int *const nearest = nearestTargets.data();
+    for (unsigned int t = 0; t < targetXs.size(); ++t) {
+        const float targetX = targetXs[t];
+        const float targetY = targetYs[t];
+        const int index = t;
+#pragma omp simd
+        for (int i = 0; i < count; ++i) {
+            const float dx = targetX - xs[i];
+            const float dy = targetY - ys[i];
+            const float squared = dx * dx + dy * dy;
+            //written as selects on the loaded distance so both become blends
+            const float before = distances[i];
+            nearest[i] = squared < before ? index : nearest[i];
+            distances[i] = squared < before ? squared : before;
+        }
     }
 }
 
@@ -253,6 +428,175 @@ void GameManager::updateBase() {
     base.updateBaseImage();
 }
 
+/**
+ * Function Interface: void queueDeletion(const UDPHeaders type, const int32_t id)
+ *      type : ZOMBIE, TURRET or BARRICADE
+ *      id : Entity to delete
+ *
+ * Description:
+ *     Queues the deletion of an entity until flushDeletions(). Anything that can die while the
+ *     marines, zombies and turrets update in parallel goes through here, so nothing is erased while
+ *     another thread is iterating over it or still holds a pointer to it.
+ *     Threads of the update team each push to their own list by thread number without a lock.
+ *     Any other thread, like the server's network thread applying an attack from its own OpenMP
+ *     team, has thread numbers that clash with the update team's, so it takes sharedDeletionLock.
+ */
+void GameManager::queueDeletion(const UDPHeaders type, const int32_t id) {
+    if (updateTeam) {
+        const unsigned int thread = omp_get_thread_num();
+        assert(thread < queuedDeletions.size());
+        queuedDeletions[thread].push_back({type, id});
+    } else {
+        std::lock_guard<std::mutex> lock(sharedDeletionLock);
+        sharedDeletions.push_back({type, id});
+    }
+}
+
+/**
+ * Function Interface: void flushDeletions()
+ *
+ * Description:
+ *     Deletes everything queued since the last flush. The update team is done by now, but other
+ *     threads can still be queueing, so the shared list is applied under its lock.
+ */
+void GameManager::flushDeletions() {
+    for (auto& deletions : queuedDeletions) {
+        applyDeletions(deletions);
+    }
+    std::lock_guard<std::mutex> lock(sharedDeletionLock);
+    applyDeletions(sharedDeletions);
+}
+
+/**
+ * Function Interface: void applyDeletions(std::vector<DeleteAction>& deletions)
+ *      deletions : List of queued deletions, emptied once they are applied
+ *
+ * Description:
+ *     Deletes everything in the list. On the server the list is then saved for the clients in one go.
+ */
+void GameManager::applyDeletions(std::vector<DeleteAction>& deletions) {
+    for (const DeleteAction& da : deletions) {
+        switch (da.entitytype) {
+            case UDPHeaders::ZOMBIE:
+                eraseZombie(da.entityid);
+                break;
+            case UDPHeaders::TURRET:
+                eraseTurret(da.entityid);
+                break;
+            case UDPHeaders::BARRICADE:
+                eraseBarricade(da.entityid);
+                break;
+            default:
+                logv("Queued deletion with unknown type\n");
+                break;
+        }
+    }
+#ifdef SERVER
+    saveDeletions(deletions);
+#endif
+    deletions.clear();
+}
+
+/**
+ * Function Interface: void queuePathChange(const int32_t id)
+ *      id : Barricade or turret that was placed, picked up or deleted
+ *
+ * Description:
+ *     Queues the barricade or turret until repairPaths(). Placing one happens before it is moved into
+ *     place, and it can come from the network thread, so only its id is kept until the end of the tick.
+ */
+void GameManager::queuePathChange(const int32_t id) {
+#pragma omp critical(pathChanges)
+    queuedPathChanges.push_back(id);
+}
+
+/**
+ * Function Interface: void repairPaths()
+ *
+ * Description:
+ *     Moves the tile each queued barricade or turret blocks on the base flow field to wherever it is now.
+ *     A placed one blocks the tile under its middle, one that was picked up or deleted blocks nothing.
+ *     Only tiles that actually change are repaired.
+ */
+void GameManager::repairPaths() {
+#pragma omp critical(pathChanges)
+    appliedPathChanges.swap(queuedPathChanges);
+
+    for (const int32_t id : appliedPathChanges) {
+        const Entity *obstacle = nullptr;
+        const auto turret = turretManager.find(id);
+        if (turret != turretManager.end()) {
+            if (turret->second.isPlaced()) {
+                obstacle = &turret->second;
+            }
+        } else {
+            const auto barricade = barricadeManager.find(id);
+            if (barricade != barricadeManager.end() && barricade->second.isPlaced()) {
+                obstacle = &barricade->second;
+            }
+        }
+
+        int col;
+        int row;
+        const bool blocks = obstacle && FlowField::tileAt(obstacle->getDestRect().x + obstacle->getDestRect().w / 2,
+            obstacle->getDestRect().y + obstacle->getDestRect().h / 2, col, row);
+        const auto old = pathBlocks.find(id);
+        if (old != pathBlocks.end()) {
+            if (blocks && old->second == row * M_WIDTH + col) {
+                continue;
+            }
+            baseFlow.unblock(old->second % M_WIDTH, old->second / M_WIDTH);
+            pathBlocks.erase(old);
+        }
+        if (blocks) {
+            baseFlow.block(col, row);
+            pathBlocks.emplace(id, row * M_WIDTH + col);
+        }
+    }
+    appliedPathChanges.clear();
+}
+
+#ifdef SERVER
+/*
+ * The network thread saves attacks and deletions while the game thread saves deletions and sends
+ * and clears them in the sync packet, so every access takes syncActionLock.
+ */
+void GameManager::saveAttack(const AttackAction& aa) {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    attackList.push_back(aa);
+}
+
+void GameManager::saveDeletion(const DeleteAction& da) {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    deleteList.push_back(da);
+}
+
+void GameManager::saveDeletions(const std::vector<DeleteAction>& deletions) {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    deleteList.insert(deleteList.end(), deletions.begin(), deletions.end());
+}
+
+std::vector<AttackAction> GameManager::getAttacks() {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    return attackList;
+}
+
+std::vector<DeleteAction> GameManager::getDeletions() {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    return deleteList;
+}
+
+void GameManager::clearAttackActions() {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    attackList.clear();
+}
+
+void GameManager::clearDeleteActions() {
+    std::lock_guard<std::mutex> lock(syncActionLock);
+    deleteList.clear();
+}
+#endif
+
 bool GameManager::hasMarine(const int32_t id) const {
     return marineManager.count(id);
 }
@@ -291,6 +635,7 @@ void GameManager::updateTurrets() {
         for (auto it = turretManager.begin(); it != turretManager.end(); ++it) {
 #pragma omp task firstprivate(it)
             {
+                const WorldScope world(this, true);
                 if (it->second.isActivated() && it->second.targetScanTurret()) {
                     it->second.shootTurret();
                 }
@@ -340,7 +685,7 @@ int32_t GameManager::createMarine() {
     SDL_Rect projRect = temp;
     SDL_Rect damRect = temp;
 
-    marineManager.emplace(id, Marine(id, marineRect, moveRect, projRect, damRect));
+    collisionHandler.insertMarine(&marineManager.emplace(id, Marine(id, marineRect, moveRect, projRect, damRect))->second);
     return id;
 }
 
@@ -363,6 +708,7 @@ bool GameManager::createMarine(const float x, const float y) {
 
     const auto& elem = marineManager.emplace(id, Marine(id, marineRect, moveRect, projRect, damRect));
     elem->second.setPosition(x,y);
+    collisionHandler.insertMarine(&elem->second);
     return true;
 }
 
@@ -374,7 +720,7 @@ void GameManager::createMarine(const int32_t id) {
     SDL_Rect projRect = temp;
     SDL_Rect damRect = temp;
 
-    marineManager.emplace(id, Marine(id, marineRect, moveRect, projRect, damRect));
+    collisionHandler.insertMarine(&marineManager.emplace(id, Marine(id, marineRect, moveRect, projRect, damRect))->second);
 }
 
 /**
@@ -386,7 +732,11 @@ void GameManager::createMarine(const int32_t id) {
  * remove the marine by its id from the marineManager
  */
 void GameManager::deleteMarine(const int32_t id) {
-    marineManager.erase(id);
+    const auto it = marineManager.find(id);
+    if (it != marineManager.end()) {
+        collisionHandler.removeMarine(&it->second);
+        marineManager.erase(it);
+    }
 #ifdef SERVER
     saveDeletion({UDPHeaders::MARINE, id});
 #endif
@@ -407,7 +757,7 @@ bool GameManager::addMarine(const int32_t id, const Marine& newMarine) {
     if (marineManager.count(id)) {
         return false;
     }
-    marineManager.emplace(id, newMarine);
+    collisionHandler.insertMarine(&marineManager.emplace(id, newMarine)->second);
     return true;
 }
 
@@ -423,9 +773,9 @@ bool GameManager::addMarine(const int32_t id, const Marine& newMarine) {
  */
 /*
 Marine& GameManager::getMarine(const int32_t id) {
-    const auto& mar = marineManager[id];
-    assert(mar.second);
-    return mar.first;
+    const auto mar = marineManager.get(id);
+    assert(mar);
+    return *mar;
 }*/
 
 /**
@@ -461,12 +811,21 @@ int32_t GameManager::createTurret() {
  *     Deletes tower from level.
  */
 void GameManager::deleteTurret(const int32_t id) {
-    turretManager.erase(id);
+    eraseTurret(id);
 #ifdef SERVER
     saveDeletion({UDPHeaders::TURRET, id});
 #endif
 }
 
+void GameManager::eraseTurret(const int32_t id) {
+    const auto it = turretManager.find(id);
+    if (it != turretManager.end()) {
+        collisionHandler.removeTurret(&it->second);
+        turretManager.erase(it);
+        queuePathChange(id);
+    }
+}
+
 /**
  * Date: Feb. 9, 2017
  * Modified: ----
@@ -521,9 +880,9 @@ int32_t GameManager::createTurret(const float x, const float y) {
  *      Get a tower by its id.
  */
 Turret& GameManager::getTurret(const int32_t id) {
-    const auto& turr = turretManager[id];
-    assert(turr.second);
-    return turr.first;
+    const auto turr = turretManager.get(id);
+    assert(turr);
+    return *turr;
 }
 
 /**
@@ -538,7 +897,7 @@ Turret& GameManager::getTurret(const int32_t id) {
  */
 int32_t GameManager::addZombie(const Zombie& newZombie) {
     const int32_t id = generateID();
-    zombieManager.emplace(id, newZombie);
+    collisionHandler.insertZombie(&zombieManager.emplace(id, newZombie)->second);
     return id;
 }
 
@@ -550,7 +909,7 @@ void GameManager::createZombie(const int32_t id) {
     SDL_Rect projRect = temp;
     SDL_Rect damRect = temp;
 
-    zombieManager.emplace(id, Zombie(id, zombieRect, moveRect, projRect, damRect));
+    collisionHandler.insertZombie(&zombieManager.emplace(id, Zombie(id, zombieRect, moveRect, projRect, damRect))->second);
 }
 
 /**
@@ -572,26 +931,82 @@ int32_t GameManager::createZombie(const float x, const float y) {
 
     const auto& elem = zombieManager.emplace(id, Zombie(id, zombieRect, moveRect, projRect, damRect));
     elem->second.setPosition(x,y);
+    collisionHandler.insertZombie(&elem->second);
     return id;
 }
 
 /**
  * Date: Feb. 8, 2017
- * Modified: ----
  * Author: Jacob McPhail
  * Function Interface: deleteZombie(const int32_t id)
  *      id : Zombie id
  *
  * Description:
- *     Deletes zombie from level.
+ *     Deletes zombie from level. Its slot and the hands it attacks with are reused by the next zombie.
  */
 void GameManager::deleteZombie(const int32_t id) {
-    zombieManager.erase(id);
+    eraseZombie(id);
 #ifdef SERVER
     saveDeletion({UDPHeaders::ZOMBIE, id});
 #endif
 }
 
+void GameManager::eraseZombie(const int32_t id) {
+    const auto it = zombieManager.find(id);
+    if (it != zombieManager.end()) {
+        collisionHandler.removeZombie(&it->second);
+        //the hands are only known locally so no deletion is sent for them
+        spareZombieHands.push_back(it->second.getWeaponId());
+        zombieManager.erase(it);
+    }
+}
+
+/**
+ * Function Interface: void reserveZombies(const unsigned int n)
+ *      n : Most zombies that will be alive at once
+ *
+ * Description:
+ *     Sizes the zombie pool for n zombies. The slots, their entries in the collision grid and a set of
+ *     hands for each are all made up front, so spawning and killing up to n zombies recycles them
+ *     instead of allocating.
+ */
+void GameManager::reserveZombies(const unsigned int n) {
+    zombieManager.reserve(n);
+    zombieSlots.reserve(n);
+    zombieHot.reserve(n);
+    colliderBatch.reserve(std::max<std::size_t>(n, marineManager.size()));
+    collisionHandler.reserveUnits(marineManager.size() + n);
+
+    const unsigned int hands = zombieManager.size() + spareZombieHands.size();
+    if (hands < n) {
+        weaponManager.reserve(weaponManager.size() + n - hands);
+        spareZombieHands.reserve(n);
+        for (unsigned int i = hands; i < n; ++i) {
+            const int32_t handId = generateID();
+            addWeapon(std::make_shared<ZombieHand>(handId));
+            spareZombieHands.push_back(handId);
+        }
+    }
+}
+
+/**
+ * Function Interface: int32_t takeZombieHand()
+ *
+ * Description:
+ *     Returns the weapon id of a set of hands for a new zombie. Hands left by a dead zombie are
+ *     reused, new ones are only made once there are none left.
+ */
+int32_t GameManager::takeZombieHand() {
+    if (spareZombieHands.empty()) {
+        const int32_t handId = generateID();
+        addWeapon(std::make_shared<ZombieHand>(handId));
+        return handId;
+    }
+    const int32_t handId = spareZombieHands.back();
+    spareZombieHands.pop_back();
+    return handId;
+}
+
 /*
     AUTHOR: Deric Mccadden 21/03/2017
     DESC: Checks if id can be found in zombieManager
@@ -605,9 +1020,9 @@ bool GameManager::zombieExists(const int32_t id) {
     DESC: returns zombie that matches id from zombieManager
  */
 Zombie& GameManager::getZombie(const int32_t id) {
-    const auto& z = zombieManager[id];
-    assert(z.second);
-    return z.first;
+    const auto z = zombieManager.get(id);
+    assert(z);
+    return *z;
 }
 /**
  * Date: March. 30, 2017
@@ -652,7 +1067,7 @@ void GameManager::removeWeapon(const int32_t id) {
  */
 int32_t GameManager::addWeaponDrop(WeaponDrop& newWeaponDrop) {
     const int32_t id = newWeaponDrop.getId();
-    weaponDropManager.emplace(id, newWeaponDrop);
+    collisionHandler.insertPickUp(&weaponDropManager.emplace(id, newWeaponDrop)->second);
     return id;
 }
 
@@ -670,7 +1085,9 @@ int32_t GameManager::createWeaponDrop(const float x, const float y, const int32_
     SDL_Rect weaponDropRect = {static_cast<int>(x),static_cast<int>(y), DEFAULT_SIZE, DEFAULT_SIZE};
     SDL_Rect pickRect = {static_cast<int>(x),static_cast<int>(y), DEFAULT_SIZE, DEFAULT_SIZE};
 
-    weaponDropManager.emplace(id, WeaponDrop(id, weaponDropRect, pickRect, wID))->second.setPosition(x,y);
+    const auto& elem = weaponDropManager.emplace(id, WeaponDrop(id, weaponDropRect, pickRect, wID));
+    elem->second.setPosition(x,y);
+    collisionHandler.insertPickUp(&elem->second);
     return id;
 }
 
@@ -696,9 +1113,9 @@ bool GameManager::weaponDropExists(const int32_t id) {
 */
 WeaponDrop& GameManager::getWeaponDrop(const int32_t id) {
     logv("id: %d\n", id);
-    const auto& wd = weaponDropManager[id];
-    assert(wd.second);
-    return wd.first;
+    const auto wd = weaponDropManager.get(id);
+    assert(wd);
+    return *wd;
 }
 
 /**
@@ -710,9 +1127,9 @@ WeaponDrop& GameManager::getWeaponDrop(const int32_t id) {
 *   Gets Weapon from Weapon Manager
 */
 std::shared_ptr<Weapon> GameManager::getWeapon(const int32_t id) {
-    const auto& w = weaponManager[id];
-    assert(w.second);
-    return w.first;
+    const auto w = weaponManager.get(id);
+    assert(w);
+    return *w;
 }
 
 /**
@@ -724,7 +1141,11 @@ std::shared_ptr<Weapon> GameManager::getWeapon(const int32_t id) {
 *  Removes WeaponDrop From WeaponDropManager
 */
 void GameManager::deleteWeaponDrop(const int32_t id) {
-    weaponDropManager.erase(id);
+    const auto it = weaponDropManager.find(id);
+    if (it != weaponDropManager.end()) {
+        collisionHandler.removePickUp(&it->second);
+        weaponDropManager.erase(it);
+    }
 #ifdef SERVER
     saveDeletion({UDPHeaders::WEAPONDROP, id});
 #endif
@@ -778,9 +1199,9 @@ void GameManager::removeConsumable(const int32_t id) {
 *  Removes Consumable from ConsumeManager
 */
 std::shared_ptr<Consumable> GameManager::getConsumable(const int32_t id) {
-    const auto& c = consumableManager[id];
-    assert(c.second);
-    return c.first;
+    const auto c = consumableManager.get(id);
+    assert(c);
+    return *c;
 }
 
 /**
@@ -798,7 +1219,9 @@ int32_t GameManager::createConsumeDrop(const float x, const float y, const int32
 
     SDL_Rect consumeDropRect = {static_cast<int>(x),static_cast<int>(y), DEFAULT_SIZE, DEFAULT_SIZE};
     SDL_Rect pickRect = {static_cast<int>(x),static_cast<int>(y), DEFAULT_SIZE, DEFAULT_SIZE};
-    consumeDropManager.emplace(id, ConsumeDrop(id, consumeDropRect, pickRect, cID))->second.setPosition(x,y);
+    const auto& elem = consumeDropManager.emplace(id, ConsumeDrop(id, consumeDropRect, pickRect, cID));
+    elem->second.setPosition(x,y);
+    collisionHandler.insertPickUp(&elem->second);
     return id;
 }
 
@@ -824,9 +1247,9 @@ bool GameManager::consumeDropExists(const int32_t id) {
 */
 ConsumeDrop& GameManager::getConsumeDrop(const int32_t id) {
     logv("id: %d\n", id);
-    const auto& cd = consumeDropManager[id];
-    assert(cd.second);
-    return cd.first;
+    const auto cd = consumeDropManager.get(id);
+    assert(cd);
+    return *cd;
 }
 
 /**
@@ -838,7 +1261,11 @@ ConsumeDrop& GameManager::getConsumeDrop(const int32_t id) {
 *  gdeletes consumedrop from consumdrop manager
 */
 void GameManager::deleteConsumeDrop(const int32_t id) {
-    consumeDropManager.erase(id);
+    const auto it = consumeDropManager.find(id);
+    if (it != consumeDropManager.end()) {
+        collisionHandler.removePickUp(&it->second);
+        consumeDropManager.erase(it);
+    }
 }
 
  /**
@@ -933,6 +1360,8 @@ int32_t GameManager::createHealthStore(const float x, const float y, SDL_Rect sc
 */
  void GameManager::addStore(const int32_t id ,std::shared_ptr<Store> store) {
      storeManager.emplace(id, store);
+     collisionHandler.insertStore(store.get());
+     collisionHandler.insertPickUp(store.get());
  }
 
  /**
@@ -956,9 +1385,9 @@ int32_t GameManager::createHealthStore(const float x, const float y, SDL_Rect sc
  *  Cgets a store from the store manager
  */
  std::shared_ptr<Store> GameManager::getStore(const int32_t id) {
-     const auto& s = storeManager[id];
-     assert(s.second);
-     return s.first;
+     const auto s = storeManager.get(id);
+     assert(s);
+     return *s;
  }
 
 /*
@@ -990,8 +1419,10 @@ int32_t GameManager::createBarricadeDrop(const float x, const float y){
     SDL_Rect barricadeDropRect = {static_cast<int>(x),static_cast<int>(y), DEFAULT_SIZE, DEFAULT_SIZE};
     SDL_Rect pickRect = {static_cast<int>(x),static_cast<int>(y), DEFAULT_SIZE, DEFAULT_SIZE};
 
-    barricadeDropManager.emplace(id, BarricadeDrop(id, barricadeDropRect, pickRect))->second.setPosition(x,y);
-    getBarricadeDrop(id).setSrcRect(WALL_SRC_X, WALL_SRC_Y, WALL_SRC_W, WALL_SRC_H);
+    const auto& elem = barricadeDropManager.emplace(id, BarricadeDrop(id, barricadeDropRect, pickRect));
+    elem->second.setPosition(x,y);
+    elem->second.setSrcRect(WALL_SRC_X, WALL_SRC_Y, WALL_SRC_W, WALL_SRC_H);
+    collisionHandler.insertPickUp(&elem->second);
     return id;
 }
 
@@ -1004,9 +1435,9 @@ int32_t GameManager::createBarricadeDrop(const float x, const float y){
 *  Gets a barricade Drop from the barricadDrop manager
 */
 BarricadeDrop& GameManager::getBarricadeDrop(const int32_t id) {
-    const auto& bd = barricadeDropManager[id];
-    assert(bd.second);
-    return bd.first;
+    const auto bd = barricadeDropManager.get(id);
+    assert(bd);
+    return *bd;
 }
 
 /**
@@ -1018,7 +1449,11 @@ BarricadeDrop& GameManager::getBarricadeDrop(const int32_t id) {
 *  Deletes barricade drop from barricade manager
 */
 void GameManager::deleteBarricadeDrop(int32_t id){
-        barricadeDropManager.erase(id);
+    const auto it = barricadeDropManager.find(id);
+    if (it != barricadeDropManager.end()) {
+        collisionHandler.removePickUp(&it->second);
+        barricadeDropManager.erase(it);
+    }
 }
 
 /**
@@ -1096,9 +1531,9 @@ void GameManager::freeDropPoint(const int32_t id) {
 *  gets a drop point from the drop point manager
 */
 DropPoint& GameManager::getDropPoint(const int32_t id) {
-    const auto& s = dropPointManager[id];
-    assert(s.second);
-    return s.first;
+    const auto s = dropPointManager.get(id);
+    assert(s);
+    return *s;
 }
 
 // Returns Collision Handler
@@ -1114,67 +1549,84 @@ CollisionHandler& GameManager::getCollisionHandler() {
  * Modified: Apr. 7, 2017 - Isaac Morneau
  *      removed object manager, added base to walls
  * Author: Jacob McPhail
- * Function Interface: void GameManager::updateCollider()
+ * Function Interface: void GameManager::updateCollider(const float delta)
+ *      delta : Delta time of the frame about to be run.
  * Description:
- *     Update colliders to current state
+ *     Update colliders to current state.
+ *     Marines and zombies are refreshed in the grid in two parallel batches, the zombies from the hot
+ *     fields copied out of them here for the rest of the tick,
+ *     turrets and barricades are added or removed as they are placed and picked up.
+ *     The wall hierarchy is only rebuilt if walls were added or removed.
+ *     Marines and zombies are then paired with everything they could reach this frame.
  */
-void GameManager::updateCollider() {
-    collisionHandler.clear();
+void GameManager::updateCollider(const float delta) {
+    collisionHandler.buildStatic();
 
-    //adding the base to the wall manager
-    //this way we dont need the object manager at all
-    collisionHandler.insertWall(&base);
+    colliderBatch.clear();
+    for (auto& m : marineManager) {
+        colliderBatch.push_back(&m.second);
+    }
+    collisionHandler.insertMarines(colliderBatch);
 
-#pragma omp parallel sections shared(collisionHandler)
-    {
-#pragma omp section
-        for (auto& m : marineManager) {
-            collisionHandler.insertMarine(&m.second);
-        }
+    zombieHot.resize(zombieManager.slotCount());
+    zombieHot.clear();
+    for (auto it = zombieManager.begin(); it != zombieManager.end(); ++it) {
+        zombieHot.load(it.handle(), it->second);
+    }
+    collisionHandler.insertZombies(zombieHot.entities, zombieHot.moveBoxes, zombieHot.extents);
 
-#pragma omp section
-        for (auto& z : zombieManager) {
-            collisionHandler.insertZombie(&z.second);
-        }
+    //one pixel more for the rounding of the moved hitbox
+    collisionHandler.buildBroadphase(std::ceil(std::max(MARINE_VELOCITY, ZOMBIE_VELOCITY) * delta) + 1);
 
-#pragma omp section
-        for (auto& w : wallManager) {
-            collisionHandler.insertWall(&w.second);
+    for (auto& t : turretManager) {
+        if (t.second.isPlaced()) {
+            collisionHandler.insertTurret(&t.second);
+        } else {
+            collisionHandler.removeTurret(&t.second);
         }
+    }
 
-#pragma omp section
-        for (auto& m : turretManager) {
-            if (m.second.isPlaced()) {
-                collisionHandler.insertTurret(&m.second);
-            }
+    for (auto& b : barricadeManager) {
+        if (b.second.isPlaced()) {
+            collisionHandler.insertBarricade(&b.second);
+        } else {
+            collisionHandler.removeBarricade(&b.second);
         }
+    }
+}
 
-#pragma omp section
-        for (auto& b : barricadeManager) {
-            if (b.second.isPlaced()) {
-                collisionHandler.insertBarricade(&b.second);
-            }
-        }
+/**
+ * Function Interface: void GameManager::rebuildCollider(const SDL_Rect& mapBounds)
+ *      mapBounds : Area covered by the map
+ *
+ * Description:
+ *     Resizes the collision trees to the map and inserts everything currently in the level.
+ *     Walls, stores, drops and the base are never touched again until they are deleted.
+ */
+void GameManager::rebuildCollider(const SDL_Rect& mapBounds) {
+    collisionHandler.setMapBounds(mapBounds);
 
-#pragma omp section
-        for (auto& m : weaponDropManager) {
-            collisionHandler.insertPickUp(&m.second);
-        }
-#pragma omp section
-        for (auto& bd : barricadeDropManager) {
-            collisionHandler.insertPickUp(&bd.second);
-        }
-#pragma omp section
-        for (auto& cd : consumeDropManager) {
-            collisionHandler.insertPickUp(&cd.second);
-        }
+    //adding the base to the wall manager
+    //this way we dont need the object manager at all
+    collisionHandler.insertWall(&base);
 
-#pragma omp section
-        for (auto& s : storeManager) {
-            collisionHandler.insertStore(s.second.get());
-            collisionHandler.insertPickUp(s.second.get());
-        }
+    for (auto& w : wallManager) {
+        collisionHandler.insertWall(&w.second);
+    }
+    for (auto& m : weaponDropManager) {
+        collisionHandler.insertPickUp(&m.second);
+    }
+    for (auto& bd : barricadeDropManager) {
+        collisionHandler.insertPickUp(&bd.second);
     }
+    for (auto& cd : consumeDropManager) {
+        collisionHandler.insertPickUp(&cd.second);
+    }
+    for (auto& s : storeManager) {
+        collisionHandler.insertStore(s.second.get());
+        collisionHandler.insertPickUp(s.second.get());
+    }
+    updateCollider(0);
 }
 
 /**
@@ -1192,7 +1644,7 @@ void GameManager::updateMarine(const PlayerData &playerData) {
     if (marineManager.count(playerData.playerid) == 0) {
         createMarine(playerData.playerid);
     }
-    Marine& marine = marineManager[playerData.playerid].first;
+    Marine& marine = *marineManager.get(playerData.playerid);
     marine.setPosition(playerData.xpos, playerData.ypos);
     marine.setDX(playerData.xdel);
     marine.setDY(playerData.ydel);
@@ -1215,7 +1667,7 @@ void GameManager::updateZombie(const ZombieData &zombieData) {
     if(zombieManager.find(zombieData.zombieid) == zombieManager.end()) {
         createZombie(zombieData.zombieid);
     }
-    Zombie& zombie = zombieManager[zombieData.zombieid].first;
+    Zombie& zombie = *zombieManager.get(zombieData.zombieid);
     zombie.setPosition(zombieData.xpos, zombieData.ypos);
     zombie.setAngle(zombieData.direction);
     zombie.setHealth(zombieData.health);
@@ -1236,16 +1688,16 @@ fires current weapon.
 */
 void GameManager::handleAttackAction(const AttackAction& attackAction) {
     if (!(attackAction.playerid == player.getId())) {
-        auto marine = marineManager[attackAction.playerid];
-        if (marine.second) {
-            int curX = marine.first.getX();
-            int curY = marine.first.getY();
-            double curAngle = marine.first.getAngle();
-            marine.first.setPosition(attackAction.xpos, attackAction.ypos);
-            marine.first.setAngle(attackAction.direction);
-            marine.first.fireWeapon();
-            marine.first.setPosition(curX, curY);
-            marine.first.setAngle(curAngle);
+        const auto marine = marineManager.get(attackAction.playerid);
+        if (marine) {
+            int curX = marine->getX();
+            int curY = marine->getY();
+            double curAngle = marine->getAngle();
+            marine->setPosition(attackAction.xpos, attackAction.ypos);
+            marine->setAngle(attackAction.direction);
+            marine->fireWeapon();
+            marine->setPosition(curX, curY);
+            marine->setAngle(curAngle);
         }
     }
 }
@@ -1273,17 +1725,26 @@ int32_t GameManager::createBarricade(const float x, const float y) {
 }
 
 void GameManager::deleteBarricade(const int32_t id) {
-    barricadeManager.erase(id);
+    eraseBarricade(id);
 #ifdef SERVER
     saveDeletion({UDPHeaders::BARRICADE, id});
 #endif
 }
 
+void GameManager::eraseBarricade(const int32_t id) {
+    const auto it = barricadeManager.find(id);
+    if (it != barricadeManager.end()) {
+        collisionHandler.removeBarricade(&it->second);
+        barricadeManager.erase(it);
+        queuePathChange(id);
+    }
+}
+
 // Get a barricade by its id
 Barricade& GameManager::getBarricade(const int32_t id) {
-    const auto& bar = barricadeManager[id];
-    assert(bar.second);
-    return bar.first;
+    const auto bar = barricadeManager.get(id);
+    assert(bar);
+    return *bar;
 }
 
 /**
@@ -1303,7 +1764,7 @@ int32_t GameManager::createWall(const float x, const float y, const int w, const
     SDL_Rect moveRect = {static_cast<int>(x), static_cast<int>(y), w, h};
     SDL_Rect pickRect = {static_cast<int>(x), static_cast<int>(y), w, h};
 
-    wallManager.emplace(id, Wall(id, wallRect, moveRect, pickRect, h, h));
+    collisionHandler.insertWall(&wallManager.emplace(id, Wall(id, wallRect, moveRect, pickRect, h, h))->second);
     return id;
 }
 
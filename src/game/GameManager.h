@@ -6,11 +6,15 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <algorithm>
 #include <iostream>
 #include <cassert>
 
 #include "../creeps/Zombie.h"
+#include "../creeps/ZombieComponents.h"
+#include "../creeps/FlowField.h"
+#include "../creeps/PathHierarchy.h"
 #include "../player/Marine.h"
 #include "../player/Player.h"
 #include "../turrets/Turret.h"
@@ -33,11 +37,14 @@
 #include "../inventory/WeaponDrop.h"
 #include "../inventory/ConsumeDrop.h"
 #include "GameHashMap.h"
+#include "SlotMap.h"
 
 static constexpr int INITVAL = 0;
 static constexpr int DEFAULT_SIZE = 100;
 static constexpr int PUSIZE = 120;
 static constexpr int DROP_POINT_SPACE = 200;//distance between drop points
+static constexpr int ZOMBIE_UPDATE_CHUNK = 32;//zombies a thread takes at a time when updating
+static constexpr int AI_TICK_BUDGET = 2000;//microseconds into the zombie update after which they stop deciding
 
 static constexpr int STORE_SIZE_W = 200; //Store width
 static constexpr int STORE_SIZE_H = 330; //Store height
@@ -74,8 +81,42 @@ static constexpr int WALL_SRC_H = 83;
 static constexpr int WALL_WIDTH = 250;
 static constexpr int WALL_HEIGHT = 250;
 
+/*
+ * Everything one match simulates: its managers, the collision handler and the AI map.
+ * Any number of them can run at once, each on its own thread. instance() is the one the calling
+ * thread is simulating, which is the default one unless a WorldScope has bound another.
+ */
 class GameManager {
 public:
+    /*
+     * Binds a world to the calling thread for as long as the scope lives, putting back whatever was
+     * bound before. Threads the update loop hands work to bind the world they were handed it from,
+     * marking themselves as part of the update team so they can queue deletions without a lock.
+     */
+    class WorldScope {
+    public:
+        WorldScope(GameManager *world, const bool updating = false) : previous(current),
+                previousUpdating(updateTeam) {
+            current = world;
+            updateTeam = updating;
+        }
+        ~WorldScope() {
+            current = previous;
+            updateTeam = previousUpdating;
+        }
+        WorldScope(const WorldScope&) = delete;
+        WorldScope& operator=(const WorldScope&) = delete;
+
+    private:
+        GameManager *previous;
+        bool previousUpdating;
+    };
+
+    GameManager();
+    ~GameManager();
+    GameManager(const GameManager&) = delete;
+    GameManager& operator=(const GameManager&) = delete;
+
     static GameManager *instance();
 
     int32_t generateID();
@@ -91,9 +132,11 @@ public:
 
     const auto& getAllMarines() const {return marineManager;}
     const auto& getAllZombies() const {return zombieManager;}
+    //hot fields of every zombie as of the last tick
+    const ZombieComponents& getZombieComponents() const {return zombieHot;}
 
     bool addMarine(const int32_t id, const Marine& newMarine);
-    auto getMarine(const int32_t id) {return marineManager[id];};
+    Marine *getMarine(const int32_t id) {return marineManager.get(id);}; // nullptr if there is no such marine
 
     Base& getBase() {return base;}
 
@@ -109,12 +152,24 @@ public:
     // Method for getting collisionHandler
     CollisionHandler& getCollisionHandler();
 
-    void updateCollider(); // Updates CollisionHandler
+    void updateCollider(const float delta); // Updates CollisionHandler for a frame of delta seconds
+    void rebuildCollider(const SDL_Rect& mapBounds); // Resizes the CollisionHandler and fills it
     void updateMarines(const float delta); // Update marine actions
     void updateZombies(const float delta); // Update zombie actions
+    // Zombies whose decision is overdue because the last tick ran out of AI_TICK_BUDGET
+    unsigned int getAiBacklog() const {return aiBacklog;}
     void updateTurrets(); // Update turret actions
     void updateBase(); // Update base images
 
+    // Deletions asked for while entities update in parallel, each thread queues them in its own list
+    void queueDeletion(const UDPHeaders type, const int32_t id);
+    void flushDeletions(); // Applies every queued deletion, once a tick after the updates
+
+    // Barricades and turrets that were placed, picked up or deleted, their tiles on the flow field are
+    // updated together once a tick, after they have been moved into place
+    void queuePathChange(const int32_t id);
+    void repairPaths();
+
     // returns the list of zombies.
     // Jamie, 2017-03-01.
     auto& getZombies() {return zombieManager;};
@@ -123,6 +178,8 @@ public:
     void createZombie(const int32_t id);
     int32_t createZombie(const float x, const float y);
     void deleteZombie(const int32_t id);
+    void reserveZombies(const unsigned int n); // Makes room for n zombies so spawning them won't allocate
+    int32_t takeZombieHand(); // Hands for a new zombie, reused from a dead one when there are any
     bool zombieExists(const int32_t id);
     Zombie& getZombie(const int32_t id);
 
@@ -191,7 +248,14 @@ public:
     auto& getAiMap() const { return AiMap; };
     void setAiMap(const std::array<std::array<bool, M_WIDTH>, M_HEIGHT>& a) {
         AiMap = a;
+        baseFlow.build(AiMap, base.getDestRect());
+        chasePaths.build(AiMap);
     }
+    // Shortest way to the base from every tile, rebuilt whenever the AI map is set and repaired
+    // whenever a barricade or turret is placed or taken away
+    const FlowField& getBaseFlow() const {return baseFlow;}
+    // Ways around the walls to anything a zombie chases, built whenever the AI map is set
+    const PathHierarchy& getChasePaths() const {return chasePaths;}
 
     void updateStores();
 
@@ -208,30 +272,97 @@ public:
 
     std::pair<float, float> getDropZoneCoords() const {return dropZoneCoord;};
 
+#ifdef SERVER
+    // Actions of this match waiting for the next sync packet to its clients, safe from any thread
+    void saveAttack(const AttackAction& aa);
+    void saveDeletion(const DeleteAction& da);
+    void saveDeletions(const std::vector<DeleteAction>& deletions);
+    std::vector<AttackAction> getAttacks();
+    std::vector<DeleteAction> getDeletions();
+    void clearAttackActions();
+    void clearDeleteActions();
+#endif
+
 private:
-    GameManager();
-    ~GameManager();
     static GameManager sInstance;
+    //world bound to this thread, nullptr for the default one
+    static thread_local GameManager *current;
+    //whether this thread is one of the update loop's team, which each have their own deletion list
+    static thread_local bool updateTeam;
+
+    // Take entities out of their manager and the collision handler, the delete functions also tell clients
+    void eraseZombie(const int32_t id);
+    void eraseTurret(const int32_t id);
+    void eraseBarricade(const int32_t id);
+    void applyDeletions(std::vector<DeleteAction>& deletions);
+    // Picks the zombies to decide this tick, then finds the closest marine or turret in sight of each
+    void scheduleThinkers();
+    void findZombieTargets();
+    void finishThinking(); // Moves on past the zombies that decided, carrying the rest
     Player player;
 
     Base base;
     std::pair<float, float> dropZoneCoord;
     CollisionHandler collisionHandler;
     std::array<std::array<bool, M_WIDTH>, M_HEIGHT> AiMap;
+    FlowField baseFlow;
+    PathHierarchy chasePaths;
     std::unique_ptr<WeaponDrop> wdPointer;
-    GameHashMap<int32_t, Marine> marineManager;
-    GameHashMap<int32_t, Zombie> zombieManager;
-    GameHashMap<int32_t, Turret> turretManager;
-    GameHashMap<int32_t, WeaponDrop> weaponDropManager;
-    GameHashMap<int32_t, std::shared_ptr<Weapon>> weaponManager;
-    GameHashMap<int32_t, Barricade> barricadeManager;
-    GameHashMap<int32_t, BarricadeDrop> barricadeDropManager;
-    GameHashMap<int32_t, Wall> wallManager;
-    GameHashMap<int32_t, std::shared_ptr<Store>> storeManager;
-    GameHashMap<int32_t, DropPoint> dropPointManager;
-    GameHashMap<int32_t,std::shared_ptr<Consumable>> consumableManager;
-    GameHashMap<int32_t, ConsumeDrop> consumeDropManager;
+    SlotMap<int32_t, Marine> marineManager;
+    SlotMap<int32_t, Zombie> zombieManager;
+    SlotMap<int32_t, Turret> turretManager;
+    SlotMap<int32_t, WeaponDrop> weaponDropManager;
+    SlotMap<int32_t, std::shared_ptr<Weapon>> weaponManager;
+    SlotMap<int32_t, Barricade> barricadeManager;
+    SlotMap<int32_t, BarricadeDrop> barricadeDropManager;
+    SlotMap<int32_t, Wall> wallManager;
+    SlotMap<int32_t, std::shared_ptr<Store>> storeManager;
+    SlotMap<int32_t, DropPoint> dropPointManager;
+    SlotMap<int32_t, std::shared_ptr<Consumable>> consumableManager;
+    SlotMap<int32_t, ConsumeDrop> consumeDropManager;
     std::vector<int32_t> openDropPoints;
+    //marines or zombies handed to the collision handler each frame, kept to save reallocating
+    std::vector<Entity *> colliderBatch;
+    //position, velocity, angle and movement hitbox of every zombie, by the slot of its handle
+    ZombieComponents zombieHot;
+    //slot of every zombie, gathered once a frame so they can be updated in parallel chunks
+    std::vector<unsigned int> zombieSlots;
+    //slots of the zombies deciding this tick, in the order they are due, and which of them got to
+    std::vector<unsigned int> zombieThinkers;
+    std::vector<uint8_t> zombieThought;
+    //id of the next zombie due to decide, or the first one after it if that zombie is gone
+    int32_t aiCursor = 0;
+    //cursor for the next tick if every zombie due this tick decides
+    int32_t aiNextRound = 0;
+    //zombies that were due but ran out of time, they go first next tick
+    unsigned int aiBacklog = 0;
+    //middle of each zombie deciding, and the squared distance and index of its closest target
+    std::vector<float> zombieXs;
+    std::vector<float> zombieYs;
+    std::vector<float> nearestDistances;
+    std::vector<int> nearestTargets;
+    //middle of every marine and placed turret, the only things zombies go after
+    std::vector<float> targetXs;
+    std::vector<float> targetYs;
+    //weapon ids of hands left behind by dead zombies, handed to the next ones spawned
+    std::vector<int32_t> spareZombieHands;
+    //deletions queued by each thread of the update team during the tick
+    std::vector<std::vector<DeleteAction>> queuedDeletions;
+    //deletions queued by any other thread, like the server's network thread, behind sharedDeletionLock
+    std::vector<DeleteAction> sharedDeletions;
+    std::mutex sharedDeletionLock;
+#ifdef SERVER
+    //attacks and deletions of this match since the last sync packet, behind syncActionLock
+    std::vector<AttackAction> attackList;
+    std::vector<DeleteAction> deleteList;
+    std::mutex syncActionLock;
+#endif
+    //barricades and turrets to update on the flow field at the end of the tick
+    std::vector<int32_t> queuedPathChanges;
+    //queue taken while it is applied, swapped back and forth to save reallocating
+    std::vector<int32_t> appliedPathChanges;
+    //tile each placed barricade and turret blocks on the flow field, as row * M_WIDTH + col
+    std::unordered_map<int32_t, int> pathBlocks;
 };
 
 
@@ -50,12 +50,12 @@ bool GameStateMatch::load() {
 #ifndef SERVER
     if (networked) {
         GameManager::instance()->getPlayer().setControl(
-                &GameManager::instance()->getMarine(NetworkManager::instance().getPlayerId()).first);
+                GameManager::instance()->getMarine(NetworkManager::instance().getPlayerId()));
         GameManager::instance()->getPlayer().setId(NetworkManager::instance().getPlayerId());
     } else {
         const Point newPoint = GameManager::instance()->getBase().getSpawnPoint();
         GameManager::instance()->getPlayer().setControl(
-                &GameManager::instance()->getMarine(GameManager::instance()->createMarine()).first);
+                GameManager::instance()->getMarine(GameManager::instance()->createMarine()));
         GameManager::instance()->getPlayer().getMarine()->setPosition(newPoint.first, newPoint.second);
         GameManager::instance()->getPlayer().getMarine()->setSrcRect(SPRITE_FRONT, SPRITE_FRONT, SPRITE_SIZE_X, SPRITE_SIZE_Y);
     }
@@ -109,7 +109,7 @@ void GameStateMatch::loop() {
         //Currently at 60, so this is fine
         //If frame rate changes, this may need limiting
         sendSyncPacket(sendSocketUDP);
-        clearAttackActions();
+        GameManager::instance()->clearAttackActions();
 #endif
 
         //If frame finished early
@@ -233,15 +233,15 @@ void GameStateMatch::handle() {
 /**
 * Date: Jan. 20, 2017
 * Author: Jacob McPhail
-* Modified: ---
 * Function Interface: update(const float delta)
 *       delta : Delta time of the fps rate.
 *
 * Description:
-*
+*       Updates everything in the match for one tick. Deletions queued during the updates are applied
+*       once they are done, then the flow field is repaired for barricades and turrets placed or removed.
 */
 void GameStateMatch::update(const float delta) {
-    GameManager::instance()->updateCollider();
+    GameManager::instance()->updateCollider(delta);
 #ifndef SERVER
     // Move player
     if (networked && GameManager::instance()->getPlayer().getMarine()) {
@@ -261,6 +261,9 @@ void GameStateMatch::update(const float delta) {
     GameManager::instance()->updateTurrets();
     GameManager::instance()->updateBase();
     GameManager::instance()->updateStores();
+    //everything that died during the updates is deleted together now nothing is iterating
+    GameManager::instance()->flushDeletions();
+    GameManager::instance()->repairPaths();
     GameManager::instance()->getPlayer().checkMarineState();
     matchManager.checkMatchState();
 
@@ -33,7 +33,7 @@ void MatchManager::checkMatchState() {
  * Author: Jacob McPhail.
  * Function Interface: spawnZombies()
  * Description:
- *      Spawns zombies at spawn points.
+ *      Spawns zombies at spawn points. Spawn points are checked with a bare hitbox instead of a zombie.
  */
 void MatchManager::spawnZombies() {
     const int currentTime = SDL_GetTicks();
@@ -42,22 +42,20 @@ void MatchManager::spawnZombies() {
     }
     spawnTick = currentTime;
 
-    const int32_t id = GameManager::instance()->createZombie(0, 0);
-    Zombie& zombie = GameManager::instance()->getZombie(id);
     CollisionHandler& ch = GameManager::instance()->getCollisionHandler();
     for (auto& pos : spawnPoints) {
         if (zombiesToSpawn <= 0) {
             break;
         }
-        zombie.setPosition(pos.x, pos.y);
-        if (!ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getMarineTree(),&zombie),&zombie)
-                || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieTree(),&zombie),&zombie)) {
+        //movement hitbox a zombie spawned here would have
+        const SDL_Rect spot = {pos.x, pos.y, ZOMBIE_WIDTH, ZOMBIE_HEIGHT};
+        if (!ch.detectMovementCollision(CollisionCategory::MARINE, spot)
+                || ch.detectMovementCollision(CollisionCategory::ZOMBIE, spot)) {
             GameManager::instance()->createZombie(pos.x, pos.y);
             --zombiesToSpawn; 
         }
     }
     logv("Zombies Spawned:%ld Still Pending:%d\n", GameManager::instance()->getZombieManager().size(), zombiesToSpawn);
-    GameManager::instance()->deleteZombie(id);
 }
 
 /**
@@ -78,10 +76,12 @@ void MatchManager::setSpawnPoints(std::vector<MapPoint> points) {
  * Author: Jacob McPhail.
  * Function Interface: newRound()
  * Description:
- *      Starts a new round, adds zombies to spawn.
+ *      Starts a new round, adds zombies to spawn and sizes the zombie pool for them.
  */
 void MatchManager::newRound() {
     //this needs to be set based on testing to provide good round scaling
     static constexpr int scaleFactor = 16;
     zombiesToSpawn = (spawnPoints.size() * ++round) * scaleFactor;
+    GameManager *gm = GameManager::instance();
+    gm->reserveZombies(gm->getZombieManager().size() + zombiesToSpawn);
 }
@@ -0,0 +1,331 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+#include <cassert>
+
+#include "FlatMap.h"
+
+/*
+ * Container the Game Manager uses to hold all the Marines, Zombies, etc.
+ * Elements live in slots inside fixed size pages, so a whole page is contiguous and iterating
+ * walks the pages in order instead of chasing the nodes of an unordered_map.
+ * Elements never move once inserted, pointers to them stay valid until they are erased, which the
+ * collision index relies on. Erased slots are reused by the next insert.
+ * Every slot has a generation that changes when its element is erased. A handle is the slot index
+ * together with its generation packed into 32 bits, so a handle to an erased element resolves
+ * to nullptr instead of whatever reused the slot.
+ * Keys are the entity ids, which come from the server as well as our own counter, so the key of each
+ * element maps to its handle through a FlatMap.
+ * After reserve(n), inserting up to n elements never allocates, which is what lets the zombies
+ * be spawned from a pool sized at the start of each round.
+ * The rest of the interface matches the unordered_map methods GameHashMap used to wrap.
+ * Iterators stay valid across inserts and erases of other elements.
+ */
+template<typename T, typename U>
+class SlotMap {
+    struct Slot;
+public:
+    typedef std::pair<const T, U> value_type;
+    typedef uint32_t Handle;
+
+    //low bits of a handle are the slot, the rest the generation
+    static constexpr unsigned int INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+    //generations start at 1 so no slot ever matches this
+    static constexpr Handle NULL_HANDLE = 0;
+    static constexpr unsigned int PAGE_BITS = 8;
+    static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+
+    template<bool Const>
+    class Iter {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename SlotMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const value_type *, value_type *>::type pointer;
+        typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+        typedef typename std::conditional<Const, const SlotMap, SlotMap>::type Map;
+
+        Iter() = default;
+        Iter(Map *map, const uint32_t slot) : map(map), slot(slot) {skip();}
+        //iterators convert to const iterators
+        operator Iter<true>() const {return Iter<true>(map, slot);}
+
+        reference operator*() const {return map->slotAt(slot).value();}
+        pointer operator->() const {return &map->slotAt(slot).value();}
+        Iter& operator++() {
+            ++slot;
+            skip();
+            return *this;
+        }
+        Iter operator++(int) {
+            Iter old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iter& other) const {return slot == other.slot;}
+        bool operator!=(const Iter& other) const {return slot != other.slot;}
+        //handle of the element, read from its slot without touching the element
+        Handle handle() const {return (map->slotAt(slot).generation << INDEX_BITS) | slot;}
+
+    private:
+        friend class SlotMap;
+        //moves on to the next slot holding an element
+        void skip() {
+            while (slot < map->used && !map->slotAt(slot).occupied) {
+                ++slot;
+            }
+        }
+
+        Map *map = nullptr;
+        uint32_t slot = 0;
+    };
+
+    typedef Iter<false> iterator;
+    typedef Iter<true> const_iterator;
+
+    SlotMap() = default;
+    ~SlotMap() {
+        clear();
+    }
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    /*
+     * Returns the element with the key, or nullptr if there isn't one.
+     * This replaces operator[], which could only hand back a reference to the end of the map
+     * when the key was missing.
+     */
+    U *get(const T& key) {
+        const Handle *handle = handles.get(key);
+        return handle ? &slotAt(*handle & INDEX_MASK).value().second : nullptr;
+    }
+
+    const U *get(const T& key) const {
+        const Handle *handle = handles.get(key);
+        return handle ? &slotAt(*handle & INDEX_MASK).value().second : nullptr;
+    }
+
+    /*
+     * Returns the handle of the element with the key, or NULL_HANDLE if there isn't one.
+     */
+    Handle getHandle(const T& key) const {
+        const Handle *handle = handles.get(key);
+        return handle ? *handle : NULL_HANDLE;
+    }
+
+    /*
+     * Returns the element a handle was made for, or nullptr if it has been erased since.
+     */
+    U *resolve(const Handle handle) {
+        Slot *slot = live(handle);
+        return slot ? &slot->value().second : nullptr;
+    }
+
+    const U *resolve(const Handle handle) const {
+        const Slot *slot = const_cast<SlotMap *>(this)->live(handle);
+        return slot ? &slot->value().second : nullptr;
+    }
+
+    iterator find(const T& key) {
+        const Handle *handle = handles.get(key);
+        return handle ? iterator(this, *handle & INDEX_MASK) : end();
+    }
+
+    const_iterator find(const T& key) const {
+        const Handle *handle = handles.get(key);
+        return handle ? const_iterator(this, *handle & INDEX_MASK) : end();
+    }
+
+    /*
+     * Inserts a key-value pair into the map.
+     * Same as GameHashMap, an element already using the key is assigned the new value
+     * instead of the insert being ignored, so this always inserts.
+     */
+    iterator insert(const value_type& elem) {
+        return insert(value_type(elem));
+    }
+
+    iterator insert(value_type&& elem) {
+        if (const Handle *handle = handles.get(elem.first)) {
+            const uint32_t index = *handle & INDEX_MASK;
+            slotAt(index).value().second = std::move(elem.second);
+            return iterator(this, index);
+        }
+        const uint32_t index = allocate();
+        Slot& slot = slotAt(index);
+        new (&slot.storage) value_type(std::move(elem));
+        slot.occupied = true;
+        handles.insert(slot.value().first, (slot.generation << INDEX_BITS) | index);
+        return iterator(this, index);
+    }
+
+    template<typename... Args>
+    iterator emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    /*
+     * Erases everything but keeps the pages, and the generations in them, so old handles stay dead.
+     */
+    void clear() {
+        for (uint32_t i = 0; i < used; ++i) {
+            if (slotAt(i).occupied) {
+                release(i);
+            }
+        }
+        freeSlots.clear();
+        handles.clear();
+        used = 0;
+    }
+
+    /*
+     * Makes room for n elements in all, so inserting until there are that many never allocates.
+     */
+    void reserve(const std::size_t n) {
+        assert(n <= INDEX_MASK + 1);
+        while (pages.size() * PAGE_SIZE < n) {
+            pages.emplace_back(new Slot[PAGE_SIZE]);
+        }
+        freeSlots.reserve(n);
+        handles.reserve(n);
+    }
+
+    void swap(SlotMap& other) {
+        std::swap(pages, other.pages);
+        std::swap(freeSlots, other.freeSlots);
+        handles.swap(other.handles);
+        std::swap(used, other.used);
+    }
+
+    /*
+     * Destroys the element and gives its slot a new generation, returning the next element.
+     */
+    iterator erase(const_iterator pos) {
+        const uint32_t index = pos.slot;
+        handles.erase(slotAt(index).value().first);
+        release(index);
+        freeSlots.push_back(index);
+        return iterator(this, index + 1);
+    }
+
+    std::size_t erase(const T& key) {
+        const auto it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    bool empty() const {
+        return handles.empty();
+    }
+
+    std::size_t size() const {
+        return handles.size();
+    }
+
+    std::size_t count(const T& key) const {
+        return handles.contains(key);
+    }
+
+    /*
+     * Slots handed out so far, every slot index is below this.
+     */
+    uint32_t slotCount() const {
+        return used;
+    }
+
+    iterator begin() {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    iterator end() {
+        return iterator(this, used);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, used);
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+private:
+    struct Slot {
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+        uint32_t generation = 1;
+        bool occupied = false;
+
+        value_type& value() {return *reinterpret_cast<value_type *>(&storage);}
+        const value_type& value() const {return *reinterpret_cast<const value_type *>(&storage);}
+    };
+
+    Slot& slotAt(const uint32_t index) {
+        return pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+    }
+
+    const Slot& slotAt(const uint32_t index) const {
+        return pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+    }
+
+    //destroys the element in a slot and moves the slot on to its next generation
+    void release(const uint32_t index) {
+        Slot& slot = slotAt(index);
+        slot.value().~value_type();
+        slot.occupied = false;
+        slot.generation = (slot.generation + 1) & GENERATION_MASK;
+        if (!slot.generation) {
+            slot.generation = 1;
+        }
+    }
+
+    //returns the slot a handle points to if it still holds the element the handle was made for
+    Slot *live(const Handle handle) {
+        const uint32_t index = handle & INDEX_MASK;
+        if (index >= used) {
+            return nullptr;
+        }
+        Slot& slot = slotAt(index);
+        return slot.occupied && slot.generation == (handle >> INDEX_BITS) ? &slot : nullptr;
+    }
+
+    //returns a free slot, erased slots are filled before the map grows so there are few gaps to skip
+    uint32_t allocate() {
+        if (!freeSlots.empty()) {
+            const uint32_t index = freeSlots.back();
+            freeSlots.pop_back();
+            return index;
+        }
+        assert(used <= INDEX_MASK);
+        if ((used >> PAGE_BITS) == pages.size()) {
+            pages.emplace_back(new Slot[PAGE_SIZE]);
+        }
+        return used++;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> pages;
+    std::vector<uint32_t> freeSlots;
+    FlatMap<T, Handle> handles;
+    //slots handed out so far, iteration stops here
+    uint32_t used = 0;
+};
+
+#endif
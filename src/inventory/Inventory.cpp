@@ -22,13 +22,12 @@
 #include "../game/GameManager.h"
 #include "../log/log.h"
 
-Inventory::Inventory(): defaultGun(GameManager::instance()->generateID()),
-        tempZombieHand(GameManager::instance()->generateID()) {
-    weaponIds[0] = defaultGun.getID();
+Inventory::Inventory() {
+    GameManager *gm = GameManager::instance();
+    weaponIds[0] = gm->generateID();
     weaponIds[1] = -1;
     weaponIds[2] = -1;
-    GameManager::instance()->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<HandGun>(defaultGun)));
-
+    gm->addWeapon(std::make_shared<HandGun>(weaponIds[0]));
 }
 
 
@@ -187,11 +186,10 @@ void Inventory::scrollCurrent(int direction) {
   * function to initialize a zombies inventory
   */
  void Inventory::initZombie(){
-     weaponIds[0] = tempZombieHand.getID();
+     weaponIds[0] = GameManager::instance()->generateID();
      weaponIds[1] = -1;
      weaponIds[2] = -1;
-     GameManager::instance()->addWeapon(std::dynamic_pointer_cast<Weapon>
-            (std::make_shared<ZombieHand>(tempZombieHand)));
+     GameManager::instance()->addWeapon(std::make_shared<ZombieHand>(weaponIds[0]));
  }
  /**
  * Date: Mar. 30, 2017
@@ -204,7 +202,6 @@ void Inventory::scrollCurrent(int direction) {
  void Inventory::makeTurretInv() {
      //Weapon *w = getCurrent();
      GameManager::instance()->removeWeapon(weaponIds[current]);
-     TurretGun tGun(GameManager::instance()->generateID());
-     weaponIds[0] = tGun.getID();
-     GameManager::instance()->addWeapon(std::dynamic_pointer_cast<Weapon>(std::make_shared<TurretGun>(tGun)));
+     weaponIds[0] = GameManager::instance()->generateID();
+     GameManager::instance()->addWeapon(std::make_shared<TurretGun>(weaponIds[0]));
  }
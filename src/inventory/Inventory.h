@@ -56,8 +56,6 @@ private:
     int current = 0;//current weapon
     std::array<int32_t, 3> weaponIds;//array of weapon ids
     int32_t consumableId = -1;
-    HandGun defaultGun;
-    ZombieHand tempZombieHand;
     //temp for now, in the future this will simply be a pointer to a consumable which is null initially
     //when this is updated, update the getMedkit function
     int slotScrollTick = 0;
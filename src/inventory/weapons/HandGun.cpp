@@ -27,17 +27,9 @@
  * Modified:    Mar 8, 2017 - Deric Mccadden
  *              Mar 13, 2017 - Mark Tattrie
  * Author: Maitiu Morton
- * Function Interface: HandGun::HandGun() : InstantWeapon(HandgunVars::TYPE, HandgunVars::FIRESOUND,
- *       HandgunVars::HITSOUND, HandgunVars::RELOADSOUND, HandgunVars::EMPTYSOUND, HandgunVars::RANGE,
- *       HandgunVars::DAMAGE, HandgunVars::AOE, HandgunVars::PENETRATION, HandgunVars::CLIP,
- *       HandgunVars::CLIPMAX, HandgunVars::AMMO, HandgunVars::RELOADDELAY, HandgunVars::FIREDELAY, id)
+ * Function Interface: HandGun::HandGun(const int32_t id) : InstantWeapon(WeaponKind::HANDGUN, id)
  * Description:
  * Ctor for HandGun
  */
-HandGun::HandGun(const int32_t id) : InstantWeapon(HandgunVars::TYPE, TEXTURES::SHOTGUN, HandgunVars::FIRESOUND,
-        HandgunVars::HITSOUND, HandgunVars::RELOADSOUND, HandgunVars::EMPTYSOUND, HandgunVars::RANGE,
-        HandgunVars::DAMAGE, HandgunVars::AOE, HandgunVars::PENETRATION, HandgunVars::ACCURACY, HandgunVars::CLIP,
-        HandgunVars::CLIPMAX, HandgunVars::AMMO, HandgunVars::RELOADDELAY, HandgunVars::FIREDELAY, HandgunVars::START_X,
-        HandgunVars::START_Y, id, HandgunVars::PRICE) {
-
+HandGun::HandGun(const int32_t id) : InstantWeapon(WeaponKind::HANDGUN, id) {
 }
@@ -32,12 +32,12 @@
 using std::string;
 
 namespace HandgunVars {
-    const string TYPE = "Handgun";
+    constexpr const char *TYPE = "Handgun";
 
-    const string FIRESOUND = EFX_WLPISTOL;
-    const string HITSOUND = "";
-    const string RELOADSOUND = EFX_WRELOAD01;
-    const string EMPTYSOUND = EFX_PDROP01;
+    constexpr const char *FIRESOUND = EFX_WLPISTOL;
+    constexpr const char *HITSOUND = "";
+    constexpr const char *RELOADSOUND = EFX_WRELOAD01;
+    constexpr const char *EMPTYSOUND = EFX_PDROP01;
 
     constexpr int RANGE = 500;
     constexpr int DAMAGE = 200;
@@ -21,7 +21,7 @@
     DISCRIPTION:
         InstantWewapon Weapons construct a line from the weapons mussle to its
         range limit, and then gets all the intersecting targets.
-        Tergets are sorted in a priority queue by distance from player, and then
+        Tergets are sorted by distance from player, and then
         they are damaged in order untill something invulnrable is hit, or
         penertation runs out.
 
@@ -29,6 +29,7 @@
 
 */
 #include <queue>
+#include <vector>
 #include <cstdio>
 #include <iostream>
 
@@ -47,23 +48,12 @@ using std::string;
  * Date: Mar 1, 2017
  * Modified: Mar 13, 2017 - Mark Tattrie
  * Author: Deric Mccadden
- * Function Interface: InstantWeapon::InstantWeapon(string type, string fireSound, string hitSound,
- *       string reloadSound, string emptySound, int range, int damage, int AOE, int penetration,
- *       int clip, int clipMax, int ammo, int reloadDelay, int fireDelay, int32_t id)
- *       : Weapon(type, fireSound, hitSound, reloadSound, emptySound, range, damage, AOE,
- *          penetration, clip, clipMax, ammo, reloadDelay, fireDelay, id)
+ * Function Interface: InstantWeapon::InstantWeapon(const WeaponKind kind, const int32_t id) : Weapon(kind, id)
  * Description:
  * Ctor for Instant Weapon
  */
 
-InstantWeapon::InstantWeapon(const string& type, TEXTURES sprite, const string& fireSound, const string& hitSound,
-        const string& reloadSound, const string& emptySound, const int range, const int damage, const int AOE,
-        const int penetration, const int accuracy, const int clip, const int clipMax, const int ammo, const int reloadDelay,
-        const int fireDelay, const int texX, const int texY, const int32_t id, const int price)
-: Weapon(type, sprite, fireSound, hitSound, reloadSound, emptySound, range, damage, AOE,
-        penetration, accuracy, clip, clipMax, ammo, reloadDelay, fireDelay, texX, texY, id, price) {
-
-
+InstantWeapon::InstantWeapon(const WeaponKind kind, const int32_t id) : Weapon(kind, id) {
 }
 
 
@@ -87,7 +77,7 @@ bool InstantWeapon::fire(Movable& movable) {
     logv(3, "InstantWeapon::fire()\n");
 
 
-    const double deviation = rand() % accuracy - (accuracy / 2);
+    const double deviation = rand() % getAccuracy() - (getAccuracy() / 2);
 
     const int gunX = movable.getX() + (MARINE_WIDTH / 2);
     const int gunY = movable.getY() + (MARINE_HEIGHT / 2);
@@ -106,7 +96,7 @@ bool InstantWeapon::fire(Movable& movable) {
     DISCRIPTION:
         construct a line from the weapons mussle to its
         range limit, and then gets all the intersecting targets.
-        Tergets are sorted in a priority queue by distance from player, and then
+        Tergets are sorted by distance from player, and then
         they are damaged in order untill something invulnrable is hit, or
         penertation runs out.
 
@@ -122,24 +112,75 @@ bool InstantWeapon::fire(Movable& movable) {
 void InstantWeapon::fireSingleProjectile(const int gunX, const int gunY, const double angle){
     TargetList targetList;
 
-    GameManager::instance()->getCollisionHandler().detectLineCollision(targetList, gunX, gunY, angle, range);
+    GameManager::instance()->getCollisionHandler().detectLineCollision(targetList, gunX, gunY, angle, getRange(),
+        getPenetration());
+
+    hitTargets(targetList);
+}
+
+
+
+/**
+    InstantWeapon::fireSpread
+
+    DISCRIPTION:
+        Fires several projectiles spread evenly over a cone. The targets for every
+        projectile are found together, then each projectile damages its own targets
+        in turn the same way a single projectile does.
+
+        int gunX, int gunY
+            The x and y coordinates of the guns muzzle.
+
+        double angle
+            the angle gun is facing.
+
+        double coneAngle
+            how far the projectiles spread out.
+
+        int numberOfShots
+            how many projectiles are fired.
+
+*/
+void InstantWeapon::fireSpread(const int gunX, const int gunY, const double angle, const double coneAngle,
+        const int numberOfShots){
+    //every shot of every spread on this thread reuses the same lists
+    thread_local std::vector<TargetList> targetLists;
+    targetLists.assign(numberOfShots, TargetList());
+
+    GameManager::instance()->getCollisionHandler().detectConeCollision(targetLists, gunX, gunY, angle, coneAngle,
+        getRange());
+
+    for (auto& targetList : targetLists) {
+        hitTargets(targetList);
+    }
+}
+
+
 
+/**
+    InstantWeapon::hitTargets
+
+    DISCRIPTION:
+        Damages the targets of one projectile in order untill something invulnrable
+        is hit, or penertation runs out, then draws the shot.
+
+        TargetList& targetList
+            The targets along the projectiles path, closest first.
+
+    AUTHOR: Deric Mccadden 01/03/17
+
+*/
+void InstantWeapon::hitTargets(TargetList& targetList){
     int finalX = targetList.getEndX();
     int finalY = targetList.getEndY();
 
-    for(int i = 0; i <= penetration; i++) {
+    for(int i = 0; i <= getPenetration(); i++) {
         if (targetList.isEmpty()) {
             logv(3, "targets.empty()\n");
             break;
         }
         Target target = targetList.getNextTarget();
 
-        //if we have run out of penatration set the end point to here.
-        if(i == penetration){
-            finalX = target.getHitX();
-            finalY = target.getHitY();
-        }
-
         //if the target is invincible break because we cant hit anything more.
         if (!target.isType(TYPE_ZOMBIE)) {
             finalX = target.getHitX();
@@ -148,17 +189,27 @@ void InstantWeapon::fireSingleProjectile(const int gunX, const int gunY, const d
             break;
         }
 
-        logv(3, "targets.size():%d\n", targetList.numTargets());
-        logv(3, "Shot target of type: %d\n", target.getType());
-
         int32_t id = target.getId();
 
+        //another projectile from the same spread can have killed it already
         if (!GameManager::instance()->zombieExists(id)) {
             logv(3, "!gameManager.zombieExists(id)\n");
-            break;
+            targetList.removeTop();
+            --i;
+            continue;
         }
+
+        //if we have run out of penatration set the end point to here.
+        if(i == getPenetration()){
+            finalX = target.getHitX();
+            finalY = target.getHitY();
+        }
+
+        logv(3, "targets.size():%d\n", targetList.numTargets());
+        logv(3, "Shot target of type: %d\n", target.getType());
+
         //damage target
-        GameManager::instance()->getZombie(id).collidingProjectile(damage);
+        GameManager::instance()->getZombie(id).collidingProjectile(getDamage());
         targetList.removeTop();
     }
     fireAnimation(targetList.getOriginX(), targetList.getOriginY(), finalX, finalY);
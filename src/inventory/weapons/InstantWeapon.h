@@ -30,17 +30,19 @@ using std::string;
 
 class InstantWeapon: public Weapon  {
 public:
-    InstantWeapon(const string& type, TEXTURES sprite, const string& fireSound, const string& hitSound, const string& reloadSound,
-            const string& emptySound, const int range, const int damage, const int AOE, const int penetration, const int accuracy,
-            const int clip, const int clipMax, const int ammo, const int reloadDelay, const int fireDelay, const int texX,
-            const int texY, const int32_t id, const int price);
+    InstantWeapon(const WeaponKind kind, const int32_t id);
     ~InstantWeapon() = default;
 
     virtual bool fire(Movable& movable);
     void fireSingleProjectile(const int gunX, const int gunY, const double angle);
+    void fireSpread(const int gunX, const int gunY, const double angle, const double coneAngle,
+        const int numberOfShots);
 
     virtual void fireAnimation(const int gunX, const int gunY, const int endX, const int endY);
 
+private:
+    void hitTargets(TargetList& targetList);
+
 };
 
 #endif
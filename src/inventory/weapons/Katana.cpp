@@ -8,19 +8,11 @@
 
 /**
  * Created by Deric Mccadden Apr/6/2017
- * Function Interface: Katana::Katana() : InstantWeapon(KatanaVars::TYPE, KatanaVars::FIRESOUND,
- *       KatanaVars::HITSOUND, KatanaVars::RELOADSOUND, KatanaVars::EMPTYSOUND, KatanaVars::RANGE,
- *       KatanaVars::DAMAGE, KatanaVars::AOE, KatanaVars::PENETRATION, KatanaVars::CLIP,
- *       KatanaVars::CLIPMAX, KatanaVars::AMMO, KatanaVars::RELOADDELAY, KatanaVars::FIREDELAY, id)
+ * Function Interface: Katana::Katana(const int32_t id) : InstantWeapon(WeaponKind::KATANA, id)
  * Description:
  * Ctor for Katana
  */
-Katana::Katana(const int32_t id) : InstantWeapon(KatanaVars::TYPE, TEXTURES::KATANA, KatanaVars::FIRESOUND,
-        KatanaVars::HITSOUND, KatanaVars::RELOADSOUND, KatanaVars::EMPTYSOUND, KatanaVars::RANGE,
-        KatanaVars::DAMAGE, KatanaVars::AOE, KatanaVars::PENETRATION, KatanaVars::ACCURACY, KatanaVars::CLIP,
-        KatanaVars::CLIPMAX, KatanaVars::AMMO, KatanaVars::RELOADDELAY, KatanaVars::FIREDELAY, KatanaVars::START_X,
-        KatanaVars::START_Y, id, KatanaVars::PRICE) {
-
+Katana::Katana(const int32_t id) : InstantWeapon(WeaponKind::KATANA, id) {
 }
 
 
@@ -51,17 +43,9 @@ bool Katana::fire(Movable& movable){
     //cone angle is how far the buckshot will spread out.
     const double coneAngle = KatanaVars::SPREAD_ANGLE;
     //number of shots is how many buckshot pellets we are firing.
-    const double numberOfShots = KatanaVars::SPREAD_SHOTS;
-    //seperation between buckshot pellets.
-    const double seperation = coneAngle / numberOfShots;
-
-    const double startAngle = angle - (coneAngle / 2);
+    const int numberOfShots = KatanaVars::SPREAD_SHOTS;
 
-    double currentAngle = startAngle;
-    for(int i = 0; i < numberOfShots; i++){
-        fireSingleProjectile(gunX, gunY, currentAngle);
-        currentAngle += seperation;
-    }
+    fireSpread(gunX, gunY, angle, coneAngle, numberOfShots);
 
     return true;
 }
@@ -13,12 +13,12 @@
 using std::string;
 
 namespace KatanaVars {
-    const string TYPE = "Katana";
+    constexpr const char *TYPE = "Katana";
 
-    const string FIRESOUND = EFX_WLPISTOL;
-    const string HITSOUND = "";
-    const string RELOADSOUND = EFX_WRELOAD01;
-    const string EMPTYSOUND = EFX_PDROP01;
+    constexpr const char *FIRESOUND = EFX_WLPISTOL;
+    constexpr const char *HITSOUND = "";
+    constexpr const char *RELOADSOUND = EFX_WRELOAD01;
+    constexpr const char *EMPTYSOUND = EFX_PDROP01;
 
     constexpr int RANGE = 150;
     constexpr int DAMAGE = 100;
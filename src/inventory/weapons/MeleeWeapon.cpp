@@ -33,19 +33,11 @@
 /**
  * Date: Mar 28, 2017
  * Author: Mark Tattrie
- * Function Interface: MeleeWeapon::MeleeWeapon(string type, TEXTURES sprite, string fireSound,
- *       string hitSound, string reloadSound, string emptySound, int range, int damage, int AOE,
- *       int penetration, int clip, int clipMax, int ammo, int reloadDelay, int fireDelay, int32_t id)
+ * Function Interface: MeleeWeapon::MeleeWeapon(const WeaponKind kind, const int32_t id) : Weapon(kind, id)
  * Description:
  * Ctor for MeleeWeapon
  */
-MeleeWeapon::MeleeWeapon(const string& type, TEXTURES sprite, const string& fireSound,
-        const string& hitSound, const string& reloadSound, const string& emptySound, const int range,
-        const int damage, const int AOE, const int penetration, const int accuracy, const int clip, const int clipMax,
-        const int ammo, const int reloadDelay, const int fireDelay, const int texX, const int texY, int32_t id, const int price)
-: Weapon(type, sprite, fireSound, hitSound, reloadSound, emptySound, range, damage, AOE,
-        penetration, accuracy, clip, clipMax, ammo, reloadDelay, fireDelay, texX, texY, id, price) {
-
+MeleeWeapon::MeleeWeapon(const WeaponKind kind, const int32_t id) : Weapon(kind, id) {
 }
 
 /**
@@ -62,6 +54,7 @@ bool MeleeWeapon::fire(Movable &mov){
         return false;
     }
 
+    const int range = getRange();
     const double degrees = mov.getAngle() - 90;
     const double radians = degrees * M_PI / 180;
 
@@ -81,19 +74,10 @@ bool MeleeWeapon::fire(Movable &mov){
     HitBox hitBox({hitBoxX, hitBoxY, hitBoxW, hitBoxH});
     CollisionHandler& ch = GameManager::instance()->getCollisionHandler();
 
-    for(const auto& x: ch.detectMeleeCollision(ch.getQuadTreeEntities(ch.getMarineTree(), &mov),&mov, hitBox)){
-        //update hit marine
-        x->collidingProjectile(damage);
-    }
-
-    for(const auto& y : ch.detectMeleeCollision(ch.getQuadTreeEntities(ch.getTurretTree(), &mov),&mov, hitBox)){
-        //update hit turret
-        y->collidingProjectile(damage);
-    }
-
-    for(const auto& z : ch.detectMeleeCollision(ch.getQuadTreeEntities(ch.getBarricadeTree(), &mov),&mov, hitBox)) {
-        //update hit barricade
-        z->collidingProjectile(damage);
+    const unsigned int targets = CollisionCategory::MARINE | CollisionCategory::TURRET | CollisionCategory::BARRICADE;
+    for(const auto& x: ch.detectMeleeCollision(ch.getQuadTreeEntities(targets, &mov),&mov, hitBox)){
+        //update hit marine, turret or barricade
+        x->collidingProjectile(getDamage());
     }
     ++clip;
 
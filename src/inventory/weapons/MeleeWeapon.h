@@ -26,10 +26,7 @@
 
 class MeleeWeapon: public Weapon {
 public:
-    MeleeWeapon(const string& type, TEXTURES sprite, const string& fireSound, const string& hitSound,
-            const string& reloadSound, const string& emptySound, const int range, const int damage,
-            const int AOE, const int penetration, const int accuracy, const int clip, const int clipMax, const int ammo,
-            const int reloadDelay, const int fireDelay, const int texX, const int texY, int32_t id, const int price);
+    MeleeWeapon(const WeaponKind kind, const int32_t id);
     ~MeleeWeapon() = default;
 
     virtual bool fire(Movable &marine);
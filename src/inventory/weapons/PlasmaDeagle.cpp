@@ -6,19 +6,9 @@
 /**
  * Date: Feb Apr/6/2017
  * Author: Deric Mccadden
- * RailGun::RailGun(const int32_t id) : InstantWeapon(PlasmaDeagleVars::TYPE, TEXTURES::RIFLE,
- 		PlasmaDeagleVars::FIRESOUND, PlasmaDeagleVars::HITSOUND, PlasmaDeagleVars::RELOADSOUND,
-        PlasmaDeagleVars::EMPTYSOUND, PlasmaDeagleVars::RANGE, PlasmaDeagleVars::DAMAGE, PlasmaDeagleVars::AOE,
-		PlasmaDeagleVars::PENETRATION, PlasmaDeagleVars::ACCURACY, PlasmaDeagleVars::CLIP, PlasmaDeagleVars::CLIPMAX,
-		PlasmaDeagleVars::AMMO, PlasmaDeagleVars::RELOADDELAY, PlasmaDeagleVars::FIREDELAY, id)
+ * PlasmaDeagle::PlasmaDeagle(const int32_t id) : InstantWeapon(WeaponKind::PLASMA_DEAGLE, id)
  * Ctor for RailGun
  */
 
-PlasmaDeagle::PlasmaDeagle(const int32_t id) : InstantWeapon(PlasmaDeagleVars::TYPE, TEXTURES::PLASMA_DEAGLE,
-		PlasmaDeagleVars::FIRESOUND, PlasmaDeagleVars::HITSOUND, PlasmaDeagleVars::RELOADSOUND,
-        PlasmaDeagleVars::EMPTYSOUND, PlasmaDeagleVars::RANGE, PlasmaDeagleVars::DAMAGE, PlasmaDeagleVars::AOE,
-        PlasmaDeagleVars::PENETRATION, PlasmaDeagleVars::ACCURACY, PlasmaDeagleVars::CLIP, PlasmaDeagleVars::CLIPMAX,
-        PlasmaDeagleVars::AMMO, PlasmaDeagleVars::RELOADDELAY, PlasmaDeagleVars::FIREDELAY, PlasmaDeagleVars::START_X,
-        PlasmaDeagleVars::START_Y, id, PlasmaDeagleVars::PRICE) {
-
+PlasmaDeagle::PlasmaDeagle(const int32_t id) : InstantWeapon(WeaponKind::PLASMA_DEAGLE, id) {
 }
@@ -13,12 +13,12 @@
 using std::string;
 
 namespace RailGunVars {
-    const string TYPE = "Railgun";
+    constexpr const char *TYPE = "Railgun";
 
-    const string FIRESOUND = EFX_WLRIFLE;
-    const string HITSOUND = "";
-    const string RELOADSOUND = EFX_WRELOAD01;
-    const string EMPTYSOUND = EFX_PDROP01;
+    constexpr const char *FIRESOUND = EFX_WLRIFLE;
+    constexpr const char *HITSOUND = "";
+    constexpr const char *RELOADSOUND = EFX_WRELOAD01;
+    constexpr const char *EMPTYSOUND = EFX_PDROP01;
 
     constexpr int RANGE = 3000;
     constexpr int DAMAGE = 300;
@@ -26,17 +26,10 @@
  * Date: Feb 8, 2017
  * Modified: Mar 13, 2017 - Mark Tattrie
  * Author: Maitiu Morton
- * Function Interface: Rifle::Rifle(int32_t id) : InstantWeapon(RifleVars::TYPE, RifleVars::FIRESOUND,
- *       RifleVars::HITSOUND, RifleVars::RELOADSOUND, RifleVars::EMPTYSOUND, RifleVars::RANGE,
- *       RifleVars::DAMAGE, RifleVars::AOE, RifleVars::PENETRATION, RifleVars::CLIP, RifleVars::CLIPMAX,
- *       RifleVars::AMMO, RifleVars::RELOADDELAY, RifleVars::FIREDELAY, id
+ * Function Interface: Rifle::Rifle(const int32_t id) : InstantWeapon(WeaponKind::RIFLE, id)
  * Description:
  * Ctor for Rifle
  */
 
-Rifle::Rifle(const int32_t id) : InstantWeapon(RifleVars::TYPE, TEXTURES::RIFLE, RifleVars::FIRESOUND, RifleVars::HITSOUND,
-        RifleVars::RELOADSOUND, RifleVars::EMPTYSOUND, RifleVars::RANGE, RifleVars::DAMAGE, RifleVars::AOE,
-        RifleVars::PENETRATION, RifleVars::ACCURACY, RifleVars::CLIP, RifleVars::CLIPMAX, RifleVars::AMMO, RifleVars::RELOADDELAY,
-        RifleVars::FIREDELAY, RifleVars::START_X, RifleVars::START_Y, id, RifleVars::PRICE) {
-
+Rifle::Rifle(const int32_t id) : InstantWeapon(WeaponKind::RIFLE, id) {
 }
@@ -31,12 +31,12 @@
 using std::string;
 
 namespace RifleVars {
-    const string TYPE = "Rifle";
+    constexpr const char *TYPE = "Rifle";
 
-    const string FIRESOUND = EFX_WLRIFLE;
-    const string HITSOUND = "";
-    const string RELOADSOUND = EFX_WRELOAD01;
-    const string EMPTYSOUND = EFX_PDROP01;
+    constexpr const char *FIRESOUND = EFX_WLRIFLE;
+    constexpr const char *HITSOUND = "";
+    constexpr const char *RELOADSOUND = EFX_WRELOAD01;
+    constexpr const char *EMPTYSOUND = EFX_PDROP01;
 
     constexpr int RANGE = 800;
     constexpr int DAMAGE = 50;
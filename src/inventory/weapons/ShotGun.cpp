@@ -29,19 +29,11 @@
  * Date: Feb 8, 2017
  * Modified: Mar 13, 2017 - Mark Tattrie
  * Author: Maitiu Morton
- * Function Interface: ShotGun::ShotGun(int32_t id) : InstantWeapon(ShotgunVars::TYPE, ShotgunVars::FIRESOUND,
- *       ShotgunVars::HITSOUND, ShotgunVars::RELOADSOUND, ShotgunVars::EMPTYSOUND,
- *       ShotgunVars::RANGE, ShotgunVars::DAMAGE, ShotgunVars::AOE, ShotgunVars::PENETRATION,
- *       ShotgunVars::CLIP, ShotgunVars::CLIPMAX, ShotgunVars::AMMO, ShotgunVars::RELOADDELAY,
- *       ShotgunVars::FIREDELAY, id)
+ * Function Interface: ShotGun::ShotGun(const int32_t id) : InstantWeapon(WeaponKind::SHOTGUN, id)
  * Description:
  * Ctor for Shotgun
  */
-ShotGun::ShotGun(const int32_t id) : InstantWeapon(ShotgunVars::TYPE, TEXTURES::SHOTGUN, ShotgunVars::FIRESOUND,
-        ShotgunVars::HITSOUND, ShotgunVars::RELOADSOUND, ShotgunVars::EMPTYSOUND, ShotgunVars::RANGE,
-        ShotgunVars::DAMAGE, ShotgunVars::AOE, ShotgunVars::PENETRATION, ShotgunVars::ACCURACY, ShotgunVars::CLIP,
-        ShotgunVars::CLIPMAX, ShotgunVars::AMMO, ShotgunVars::RELOADDELAY, ShotgunVars::FIREDELAY, ShotgunVars::START_X,
-        ShotgunVars::START_Y, id, ShotgunVars::PRICE) {
+ShotGun::ShotGun(const int32_t id) : InstantWeapon(WeaponKind::SHOTGUN, id) {
 }
 
 
@@ -71,17 +63,9 @@ bool ShotGun::fire(Movable& movable){
     //cone angle is how far the buckshot will spread out.
     const double coneAngle = ShotgunVars::SPREAD_ANGLE;
     //number of shots is how many buckshot pellets we are firing.
-    const double numberOfShots = ShotgunVars::SPREAD_SHOTS;
-    //seperation between buckshot pellets.
-    const double seperation = coneAngle / numberOfShots;
+    const int numberOfShots = ShotgunVars::SPREAD_SHOTS;
 
-    const double startAngle = angle - (coneAngle / 2);
-
-    double currentAngle = startAngle;
-    for(int i = 0; i < numberOfShots; i++){
-        fireSingleProjectile(gunX, gunY, currentAngle);
-        currentAngle += seperation;
-    }
+    fireSpread(gunX, gunY, angle, coneAngle, numberOfShots);
 
     return true;
 }
@@ -28,6 +28,9 @@
 #ifndef TARGET_H
 #define TARGET_H
 
+#include <vector>
+#include <algorithm>
+
 #include "../../basic/Entity.h"
 
 #define TYPE_ZOMBIE 0
@@ -68,6 +71,7 @@ public:
     int getType() const {return type;}
     int getHitX() const {return hitX;}
     int getHitY() const {return hitY;}
+    int getPlayerDist() const {return playerDist;}
     bool isType(int check){return check == type;}
 
 private:
@@ -85,6 +89,8 @@ private:
     DISCRIPTION:
         This is used to store all the targets allong the weapons firing path.
         Targets will be sorted by distance from origin.
+        The collision handler finds targets closest first, so they are kept in a plain
+        vector with each new target inserted after every target at the same distance or closer.
 
     PARAMATERS:
         originX and originY represent the muzzle of the gun.
@@ -97,11 +103,14 @@ private:
 class TargetList{
 public:
 
-    void addTarget(const Target t){targets.push(t);}
-    const Target& getNextTarget() {return targets.top();}
-    void removeTop(){targets.pop();}
-    bool isEmpty(){return targets.empty();}
-    int numTargets(){return targets.size();}
+    void addTarget(const Target t){
+        targets.insert(std::upper_bound(targets.begin() + next, targets.end(), t,
+            [](const Target& lhs, const Target& rhs){return lhs.getPlayerDist() < rhs.getPlayerDist();}), t);
+    }
+    const Target& getNextTarget() {return targets[next];}
+    void removeTop(){++next;}
+    bool isEmpty(){return next == targets.size();}
+    int numTargets(){return targets.size() - next;}
 
     int getOriginX() const {return originX;}
     int getOriginY() const {return originY;}
@@ -113,7 +122,9 @@ public:
     void setEndY(const int y) {endY = y;}
     
 private:
-    std::priority_queue<Target> targets;
+    std::vector<Target> targets;
+    //index of the closest target that has not been removed
+    unsigned int next = 0;
     int originX;
     int originY;
     int endX;
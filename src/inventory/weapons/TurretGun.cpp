@@ -9,9 +9,5 @@
  */
 #include "TurretGun.h"
 
-TurretGun::TurretGun(int32_t id) : InstantWeapon(TurretGunVars::TYPE, TEXTURES::SHOTGUN, TurretGunVars::FIRESOUND, TurretGunVars::HITSOUND,
-        TurretGunVars::RELOADSOUND, TurretGunVars::EMPTYSOUND, TurretGunVars::RANGE, TurretGunVars::DAMAGE,
-        TurretGunVars::AOE, TurretGunVars::PENETRATION, TurretGunVars::ACCURACY, TurretGunVars::CLIP, TurretGunVars::CLIPMAX, TurretGunVars::AMMO,
-        TurretGunVars::RELOADDELAY, TurretGunVars::FIREDELAY, 0, 0, id, TurretGunVars::PRICE) {
-
+TurretGun::TurretGun(const int32_t id) : InstantWeapon(WeaponKind::TURRET_GUN, id) {
 }
@@ -14,12 +14,12 @@
 using std::string;
 
 namespace TurretGunVars {
-    const string TYPE = "TurretGun";
+    constexpr const char *TYPE = "TurretGun";
 
-    const string FIRESOUND = EFX_WTURRET;
-    const string HITSOUND = "";
-    const string RELOADSOUND = "";
-    const string EMPTYSOUND = "";
+    constexpr const char *FIRESOUND = EFX_WTURRET;
+    constexpr const char *HITSOUND = "";
+    constexpr const char *RELOADSOUND = "";
+    constexpr const char *EMPTYSOUND = "";
 
     constexpr int RANGE = 400;
     constexpr int DAMAGE = 75;
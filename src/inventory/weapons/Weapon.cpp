@@ -37,27 +37,14 @@ using std::string;
  *  Feb 9, 2017 - Jacob McPhail
  *  Mar 13, 2017 - Mark Tattrie
  * Author: Maitiu Morton
- * Function Interface: Weapon::Weapon(const string& type, TEXTURES sprite, const string& fireSound,
- *       const string& hitSound, const string& reloadSound, const string& emptySound, const int range,
- *       const int damage, const int AOE, const int penetration, const int clip, const int clipMax,
- *       const int ammo, const int reloadDelay, const int fireDelay, int32_t id)
+ * Function Interface: Weapon::Weapon(const WeaponKind kind, const int32_t id)
+ *      kind : Archetype the weapon's stats, sounds and sprite are read from
+ *      id : Id of the weapon
  * Description:
- * Ctor for Weapon
+ * Ctor for Weapon, starting with the clip and ammo of its archetype
  */
-Weapon::Weapon(const string& type, TEXTURES sprite, const string& fireSound, const string& hitSound, const string& reloadSound,
-        const string& emptySound, const int range, const int damage, const int AOE, const int penetration, const int accuracy,
-        const int clip, const int clipMax, const int ammo, const int reloadDelay, const int fireDelay, const int texX,
-        const int texY, int32_t id, const int p) : weaponSrc({texX, texY, WEAPON_WIDTH, WEAPON_HEIGHT}),rotate{0, 0},
-        type(type), spriteType(sprite), fireSound(fireSound), hitSound(hitSound), reloadSound(reloadSound), emptySound(emptySound),
-        range(range), damage(damage), AOE(AOE), penetration(penetration), accuracy(accuracy), clip(clip), clipMax(clipMax),
-        ammo(ammo), reloadDelay(reloadDelay), fireDelay(fireDelay), reloadTick(0), fireTick(0),  wID(id), price(p){
-}
-
-Weapon::Weapon(const Weapon& w)
-        : weaponSrc(w.weaponSrc), rotate(w.rotate), type(w.type), spriteType(w.spriteType), fireSound(w.fireSound),
-        hitSound(w.hitSound), reloadSound(w.reloadSound), emptySound(w.emptySound), range(w.range), damage(w.damage), AOE(w.AOE),
-        penetration(w.penetration), accuracy(w.accuracy), clip(w.clip), clipMax(w.clipMax), ammo(w.ammo),
-        reloadDelay(w.reloadDelay), fireDelay(w.fireDelay), reloadTick(w.reloadTick), fireTick(w.fireTick), wID(w.getID()), price(w.getPrice()){
+Weapon::Weapon(const WeaponKind kind, const int32_t id) : clip(::getArchetype(kind).clip),
+        ammo(::getArchetype(kind).ammo), reloadTick(0), fireTick(0), wID(id), kind(kind) {
 }
 
 
@@ -75,19 +62,20 @@ bool Weapon::reduceClip(const int rounds){
 //Mark T    3/8/2017
 //Deric M       3/15/2017
 bool Weapon::reloadClip(){
+    const WeaponArchetype& stats = getArchetype();
     int currentTime = SDL_GetTicks();
-    if(currentTime < (reloadTick + reloadDelay)){
+    if(currentTime < (reloadTick + stats.reloadDelay)){
         return false;
     }
     reloadTick = currentTime;
     //must wait extra time to fire from reloading
-    fireTick += reloadDelay;
+    fireTick += stats.reloadDelay;
     if(ammo <= 0){
-        AudioManager::instance().playEffect(emptySound.c_str());
+        AudioManager::instance().playEffect(stats.emptySound);
         return false;
     }
 
-    int ammoNeeded = clipMax - clip;
+    int ammoNeeded = stats.clipMax - clip;
     if(ammo < ammoNeeded){
         clip += ammo;
         ammo = 0;
@@ -95,7 +83,7 @@ bool Weapon::reloadClip(){
     }
     ammo -= ammoNeeded;
     clip += ammoNeeded;
-    AudioManager::instance().playEffect(reloadSound.c_str());
+    AudioManager::instance().playEffect(stats.reloadSound);
 
     return true;
 }
@@ -105,7 +93,7 @@ bool Weapon::reloadClip(){
 //Deric M       3/15/2017
 bool Weapon::chamberRound() {
     int currentTime = SDL_GetTicks();
-    if(currentTime < (fireTick + fireDelay)){
+    if(currentTime < (fireTick + getFireRate())){
         return false;
     }
     fireTick = currentTime;
@@ -125,7 +113,7 @@ bool Weapon::fire(Movable& movable){
     if (networked) {
         GameManager::instance()->getPlayer().sendServAttackAction();
     }
-    AudioManager::instance().playEffect(fireSound.c_str());
+    AudioManager::instance().playEffect(getArchetype().fireSound);
     return true;
 }
 
@@ -133,6 +121,10 @@ void Weapon::updateGunRender(const Movable& mov, const SDL_Rect& camera) {
     static constexpr int WEAPON_DISP_WIDTH = 100;
     static constexpr int WEAPON_DISP_HEIGHT = 60;
     const auto& dest = mov.getRelativeDestRect(camera);
+    const WeaponArchetype& stats = getArchetype();
+    const SDL_Rect weaponSrc = {stats.texX, stats.texY, WEAPON_WIDTH, WEAPON_HEIGHT};
+    SDL_Rect weaponDest;
+    SDL_Point rotate = {0, 0};
 
     weaponDest.x = dest.x + dest.w / 2;
     weaponDest.y = dest.y + dest.h / 2;
@@ -26,6 +26,7 @@
 
 #include <SDL2/SDL.h>
 #include <string>
+#include "WeaponArchetype.h"
 #include "../../sprites/SpriteTypes.h"
 
 //taken from the spritesheet
@@ -40,29 +41,28 @@ class Movable;
 class Weapon {
 public:
 
-    Weapon(const string& type = "no type", TEXTURES sprite = TEXTURES::CONCRETE, const string& fireSound = "", const string& hitSound = "",
-        const string& reloadSound = "", const string& emptySound = "", const int range = 0,
-        const int damage = 0, const int AOE = 0, const int penetration = 0, const int accuracy = 0, const int clip = 0,
-        const int clipMax = 0, const int ammo = 0, const int reloadDelay = 0, const int fireDelay = 0, const int texX = 0,
-        const int texY = 0, int32_t id = -1, const int p = 0);
-
-    Weapon(const Weapon& w);
+    Weapon(const WeaponKind kind, const int32_t id = -1);
     ~Weapon() = default;
 
-    string getType() const { return type; }
+    WeaponKind getKind() const {return kind;}
+    const WeaponArchetype& getArchetype() const {return ::getArchetype(kind);}
+
+    const char *getType() const { return getArchetype().type; }
 
-    int getRange() const { return range; }
-    int getDamage() const { return damage; }
-    int getAOE() const { return AOE; }
+    int getRange() const { return getArchetype().range; }
+    int getDamage() const { return getArchetype().damage; }
+    int getAOE() const { return getArchetype().AOE; }
+    int getPenetration() const { return getArchetype().penetration; }
+    int getAccuracy() const { return getArchetype().accuracy; }
 
     int getClip() const { return clip; }
-    int getClipMax() const { return clipMax; }
+    int getClipMax() const { return getArchetype().clipMax; }
     int getAmmo() const { return ammo; }
 
-    int getReloadSpeed() const { return reloadDelay; }
-    int getFireRate() const { return fireDelay; }
+    int getReloadSpeed() const { return getArchetype().reloadDelay; }
+    int getFireRate() const { return getArchetype().fireDelay; }
 
-    TEXTURES getTexture() const{ return spriteType;};
+    TEXTURES getTexture() const{ return getArchetype().sprite;};
 
     bool reduceClip(const int rounds);
     bool reloadClip();
@@ -72,44 +72,21 @@ public:
 
     virtual bool fire(Movable& movable);
 
-    int getPrice() const {return price;};
+    int getPrice() const {return getArchetype().price;};
 
     virtual void updateGunRender(const Movable& mov, const SDL_Rect& camera);
 
 protected:
-
-    SDL_Rect weaponSrc;
-    SDL_Rect weaponDest;
-    SDL_Point rotate;
-
-    string type;
-
-    TEXTURES spriteType;
-    string fireSound;
-    string hitSound;
-    string reloadSound;
-    string emptySound;
-
-    int range;
-    int damage;
-    int AOE;
-    int penetration;
-    int accuracy;
-
+    //everything else is shared by every weapon of the same kind through its archetype
     int clip;
-    int clipMax;
     int ammo;
-    int reloadDelay;
-    int fireDelay;
 
     int reloadTick;
     int fireTick;
 
     int32_t wID;
 
-
-    int price;
-
+    WeaponKind kind;
 };
 
 int32_t generateWID();
@@ -0,0 +1,54 @@
+/*------------------------------------------------------------------------------
+* Source: WeaponArchetype.cpp
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Archetype of every kind of weapon, in the order of WeaponKind.
+*
+------------------------------------------------------------------------------*/
+#include "WeaponArchetype.h"
+#include "HandGun.h"
+#include "Rifle.h"
+#include "ShotGun.h"
+#include "PlasmaDeagle.h"
+#include "RailGun.h"
+#include "Type75.h"
+#include "Katana.h"
+#include "PhaseRepeater.h"
+#include "TurretGun.h"
+#include "ZombieHand.h"
+
+//fills an archetype from the Vars namespace of a weapon
+#define ARCHETYPE(VARS, SPRITE, TEX_X, TEX_Y) {VARS::TYPE, SPRITE, VARS::FIRESOUND, VARS::HITSOUND, \
+    VARS::RELOADSOUND, VARS::EMPTYSOUND, VARS::RANGE, VARS::DAMAGE, VARS::AOE, VARS::PENETRATION, \
+    VARS::ACCURACY, VARS::CLIP, VARS::CLIPMAX, VARS::AMMO, VARS::RELOADDELAY, VARS::FIREDELAY, \
+    TEX_X, TEX_Y, VARS::PRICE}
+
+constexpr WeaponArchetype WEAPON_ARCHETYPES[static_cast<int>(WeaponKind::COUNT)] = {
+    ARCHETYPE(HandgunVars, TEXTURES::SHOTGUN, HandgunVars::START_X, HandgunVars::START_Y),
+    ARCHETYPE(RifleVars, TEXTURES::RIFLE, RifleVars::START_X, RifleVars::START_Y),
+    ARCHETYPE(ShotgunVars, TEXTURES::SHOTGUN, ShotgunVars::START_X, ShotgunVars::START_Y),
+    ARCHETYPE(PlasmaDeagleVars, TEXTURES::PLASMA_DEAGLE, PlasmaDeagleVars::START_X, PlasmaDeagleVars::START_Y),
+    ARCHETYPE(RailGunVars, TEXTURES::RAILGUN, RailGunVars::START_X, RailGunVars::START_Y),
+    ARCHETYPE(Type75Vars, TEXTURES::TYPE_75K, Type75Vars::START_X, Type75Vars::START_Y),
+    ARCHETYPE(KatanaVars, TEXTURES::KATANA, KatanaVars::START_X, KatanaVars::START_Y),
+    ARCHETYPE(PhaseRepeaterVars, TEXTURES::PHASE_REPEATER, PhaseRepeaterVars::START_X, PhaseRepeaterVars::START_Y),
+    ARCHETYPE(TurretGunVars, TEXTURES::SHOTGUN, 0, 0),
+    ARCHETYPE(ZombieHandVars, TEXTURES::SHOTGUN, 0, 0),
+};
+
+#undef ARCHETYPE
+
+static_assert(WEAPON_ARCHETYPES[static_cast<int>(WeaponKind::HANDGUN)].type == HandgunVars::TYPE
+    && WEAPON_ARCHETYPES[static_cast<int>(WeaponKind::ZOMBIE_HAND)].type == ZombieHandVars::TYPE,
+    "WEAPON_ARCHETYPES is out of order with WeaponKind");
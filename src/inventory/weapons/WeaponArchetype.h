@@ -0,0 +1,78 @@
+/*------------------------------------------------------------------------------
+* Header: WeaponArchetype.h
+*
+* Functions:
+*
+*
+* Date:
+*
+* Revisions:
+*
+* Designer:
+*
+* Author:
+*
+* Notes:
+*       Everything about a kind of weapon that never changes once it is made, its stats, sounds, price
+*       and where it is on the spritesheet, is kept once per kind in WEAPON_ARCHETYPES instead of
+*       being copied into every weapon. The table is built at compile time from each weapon's Vars
+*       namespace, so a weapon only holds its kind and the clip, ammo and timers that change as it fires.
+*
+------------------------------------------------------------------------------*/
+#ifndef WEAPONARCHETYPE_H
+#define WEAPONARCHETYPE_H
+
+#include <cstdint>
+#include "../../sprites/SpriteTypes.h"
+
+//index of each weapon's archetype in WEAPON_ARCHETYPES
+enum class WeaponKind : uint8_t {
+    HANDGUN,
+    RIFLE,
+    SHOTGUN,
+    PLASMA_DEAGLE,
+    RAILGUN,
+    TYPE75,
+    KATANA,
+    PHASE_REPEATER,
+    TURRET_GUN,
+    ZOMBIE_HAND,
+    COUNT
+};
+
+struct WeaponArchetype {
+    const char *type;
+    TEXTURES sprite;
+
+    const char *fireSound;
+    const char *hitSound;
+    const char *reloadSound;
+    const char *emptySound;
+
+    int range;
+    int damage;
+    int AOE;
+    int penetration;
+    int accuracy;
+
+    //clip and ammo a new weapon starts with
+    int clip;
+    int clipMax;
+    int ammo;
+    int reloadDelay;
+    int fireDelay;
+
+    //top left of the weapon on the spritesheet
+    int texX;
+    int texY;
+
+    int price;
+};
+
+extern const WeaponArchetype WEAPON_ARCHETYPES[static_cast<int>(WeaponKind::COUNT)];
+
+inline const WeaponArchetype& getArchetype(const WeaponKind kind) {
+    return WEAPON_ARCHETYPES[static_cast<int>(kind)];
+}
+
+#endif
@@ -31,12 +31,12 @@
 
 
 namespace ZombieHandVars {
-    const std::string TYPE = "ZombieHand";
+    constexpr const char *TYPE = "ZombieHand";
 
-    const std::string FIRESOUND = "";
-    const std::string HITSOUND = "";
-    const std::string RELOADSOUND = EFX_WRELOAD01;
-    const std::string EMPTYSOUND = EFX_PDROP01;
+    constexpr const char *FIRESOUND = "";
+    constexpr const char *HITSOUND = "";
+    constexpr const char *RELOADSOUND = EFX_WRELOAD01;
+    constexpr const char *EMPTYSOUND = EFX_PDROP01;
 
     constexpr int RANGE = 100;
     constexpr int DAMAGE = 20;
@@ -164,6 +164,7 @@ void Map::genWalls(const vector<MapPoint>& wallStart) {
  * Description:
  * Creates the wall structures using the GameManager createWall function.
  * Creates and loads shop and dropzone positions.
+ * The collision index is sized to the map and filled once everything is created.
  */
 void Map::mapLoadToGame(SDL_Rect screenRect) {
     // Random shop position variable.
@@ -194,6 +195,8 @@ void Map::mapLoadToGame(SDL_Rect screenRect) {
     GameManager::instance()->createBarricadeDrop(tShopPosition.x + 500, hShopPosition.y);
     // Only using one drop zone position.
     GameManager::instance()->createDropZone(dropPoints[0].x, dropPoints[0].y, DROPZONE_SIZE);
+
+    GameManager::instance()->rebuildCollider(getBounds());
 }
 
 /**
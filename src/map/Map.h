@@ -62,6 +62,8 @@ public:
     const std::string getFile() const { return fname; };
     const std::vector<MapPoint> getZombieSpawn() const { return zombieSpawn; };
     const std::array<std::array<bool, M_WIDTH>, M_HEIGHT> getAIMap() const { return AIMap; };
+    // Pixel area covered by the map
+    static constexpr SDL_Rect getBounds() { return {0, 0, M_WIDTH * T_SIZE, M_HEIGHT * T_SIZE}; };
 
 private:
     std::string fname;
@@ -94,14 +94,14 @@ int32_t Marine::checkForPickUp() {
     GameManager *gm = GameManager::instance();
     CollisionHandler& ch = gm->getCollisionHandler();
 
-    Entity *ep = ch.detectPickUpCollision(ch.getQuadTreeEntities(ch.getStoreTree(),this),this);
+    Entity *ep = ch.detectPickUpCollision(CollisionCategory::STORE, this);
     if(ep){
         activateStore(ep);
         return -1;
     }
 
     // checks if Id matches any turret Ids in turretManager, if yes, then return with the Id
-    ep = ch.detectPickUpCollision(ch.getQuadTreeEntities(ch.getTurretTree(),this),this);
+    ep = ch.detectPickUpCollision(CollisionCategory::TURRET, this);
     if(ep) {
         pickId = ep->getId();
         if (gm->getTurretManager().count(pickId)) {
@@ -109,7 +109,7 @@ int32_t Marine::checkForPickUp() {
         }
     }
 
-    ep = ch.detectPickUpCollision(ch.getQuadTreeEntities(ch.getPickUpTree(),this),this);
+    ep = ch.detectPickUpCollision(CollisionCategory::PICKUP, this);
     if(ep) {
         //get Entity drop Id
         pickId = ep->getId();
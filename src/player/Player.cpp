@@ -416,7 +416,7 @@ bool Player::checkMarineState() {
 void Player::respawn(const Point& newPoint) {
     const int32_t playerMarineID = GameManager::instance()->createMarine();
     //gives the player control of the marine
-    setControl(&GameManager::instance()->getMarine(playerMarineID).first);
+    setControl(GameManager::instance()->getMarine(playerMarineID));
     getMarine()->setPosition(newPoint.first, newPoint.second);
     getMarine()->setSrcRect(SPRITE_FRONT, SPRITE_FRONT, SPRITE_SIZE_X, SPRITE_SIZE_Y);
 }
@@ -142,6 +142,8 @@ void listenForPackets(sockaddr_in& servaddr) {
  * John Agapeyev March 19
  */
 void processPacket(const char *data) {
+    //handlers run on the network threads, which have to bind the world the packets are for
+    const GameManager::WorldScope world(gm);
     const ClientMessage *mesg = reinterpret_cast<const ClientMessage *>(data);
     switch (static_cast<UDPHeaders>(mesg->id)) {
         case UDPHeaders::WALK:
@@ -154,7 +156,7 @@ void processPacket(const char *data) {
             {
                 const AttackAction& aa = mesg->data.aa;
                 performAttack(aa);
-                saveAttack(aa);
+                gm->saveAttack(aa);
             }
             break;
         case UDPHeaders::BARRICADEACTIONH:
@@ -214,9 +216,10 @@ std::string genOutputPacket() {
     pBuff = reinterpret_cast<int32_t *>(pPlayer);
 
     *pBuff++ = static_cast<int32_t>(UDPHeaders::ATTACKACTIONH);
-    *pBuff++ = attackList.size();
+    const auto& attacks = GameManager::instance()->getAttacks();
+    *pBuff++ = attacks.size();
     AttackAction *pAttack = reinterpret_cast<AttackAction *>(pBuff);
-    for (const auto& aa : attackList) {
+    for (const auto& aa : attacks) {
         memcpy(pAttack++, &aa, sizeof(AttackAction));
     }
     pBuff = reinterpret_cast<int32_t *>(pAttack);
@@ -235,7 +238,7 @@ std::string genOutputPacket() {
 
     *pBuff++ = static_cast<int32_t>(UDPHeaders::DELETE);
 
-    const auto& deletions = getDeletions();
+    const auto& deletions = GameManager::instance()->getDeletions();
     *pBuff++ = deletions.size();
     DeleteAction *pDelete = reinterpret_cast<DeleteAction *>(pBuff);
     for(const auto& d : deletions) {
@@ -257,7 +260,7 @@ std::string genOutputPacket() {
 void sendSyncPacket(const int sock) {
     static std::atomic<int> counter{0};
     if (++counter >= 2) {
-        clearDeleteActions();
+        GameManager::instance()->clearDeleteActions();
         counter.store(0);
     }
     const auto& packet = genOutputPacket();
@@ -8,30 +8,9 @@
 #include "../game/GameManager.h"
 #include "servergamestate.h"
 
-GameManager *gm = GameManager::GameManager::instance();
-std::vector<AttackAction> attackList;
-std::vector<DeleteAction> deleteList;
-
-/**
- * Saves a attack action in the vector.
- * This vector stores every attack action received since the last sync packet was sent.
- * John Agapeyev March 19
- */
-void saveAttack(const AttackAction& aa) {
-    attackList.push_back(aa);
-}
-
-/**
- * Clears all the stored attack actions.
- * John Agapeyev March 19
- */
-void clearAttackActions() {
-    attackList.clear();
-}
-
-void clearDeleteActions() {
-    deleteList.clear();
-}
+//world the match on the listening sockets runs in, packets from its clients are applied here,
+//and the handlers applying them bind it to their thread
+GameManager *gm = GameManager::instance();
 
 /**
  * Updates a player marine based on a given move action struct.
@@ -40,12 +19,12 @@ void clearDeleteActions() {
 void updateMarine(const MoveAction& ma) {
     std::lock_guard<std::mutex> lock(mut);
     if (gm->hasMarine(ma.id)) {
-        const auto& p = gm->getMarine(ma.id);
-        if (!p.second) {
+        const auto p = gm->getMarine(ma.id);
+        if (!p) {
             logv("Marine not found with id %d\n", ma.id);
             return;
         }
-        auto& marine = p.first;
+        auto& marine = *p;
         marine.setPosition(ma.xpos, ma.ypos);
         marine.setDX(ma.xdel);
         marine.setDY(ma.ydel);
@@ -59,12 +38,12 @@ void updateMarine(const MoveAction& ma) {
 void performAttack(const AttackAction& aa) {
     std::lock_guard<std::mutex> lock(mut);
     if (gm->hasMarine(aa.playerid)) {
-        const auto& p = gm->getMarine(aa.playerid);
-        if (!p.second) {
+        const auto p = gm->getMarine(aa.playerid);
+        if (!p) {
             logv("Marine not found with id %d\n", aa.playerid);
             return;
         }
-        auto& marine = p.first;
+        auto& marine = *p;
         marine.setPosition(aa.xpos, aa.ypos);
         marine.setAngle(aa.direction);
 
@@ -81,7 +60,7 @@ void performAttack(const AttackAction& aa) {
 
 void processBarricade(const BarricadeAction& ba) {
     std::lock_guard<std::mutex> lock(mut);
-    Barricade& tempBarricade = GameManager::instance()->getBarricade(ba.barricadeid);
+    Barricade& tempBarricade = gm->getBarricade(ba.barricadeid);
     if (ba.actionid == UDPHeaders::PICKUP) {
         //No noticeable code in game logic for picking up a barricade
     } else if (ba.actionid == UDPHeaders::DROPOFF) {
@@ -96,7 +75,7 @@ void processBarricade(const BarricadeAction& ba) {
 
 void processTurret(const TurretAction& ta) {
     std::lock_guard<std::mutex> lock(mut);
-    Turret& tempTurret = GameManager::instance()->getTurret(ta.turretid);
+    Turret& tempTurret = gm->getTurret(ta.turretid);
     if (ta.actionid == UDPHeaders::PICKUP) {
         tempTurret.pickUpTurret();
         tempTurret.setPosition(ta.xpos, ta.ypos);
@@ -148,25 +127,32 @@ std::vector<ZombieData> getZombies() {
     std::vector<ZombieData> rtn;
     ZombieData tempZombie;
     std::lock_guard<std::mutex> lock(mut);
-    for (const auto& idZombiePair : gm->getAllZombies()) {
-        const auto& zombie = idZombiePair.second;
+    const auto& zombies = gm->getAllZombies();
+    const ZombieComponents& hot = gm->getZombieComponents();
+    for (auto it = zombies.begin(); it != zombies.end(); ++it) {
+        const auto& zombie = it->second;
         memset(&tempZombie, 0, sizeof(tempZombie));
 
-        tempZombie.zombieid = idZombiePair.first;
+        tempZombie.zombieid = it->first;
         tempZombie.health = zombie.getHealth();
-        tempZombie.xpos = zombie.getX();
-        tempZombie.ypos = zombie.getY();
-        tempZombie.direction = zombie.getAngle();
+        //zombies made since the tick started are not in the arrays yet
+        const auto handle = it.handle();
+        if (hot.holds(handle)) {
+            const uint32_t slot = handle & SlotMap<int32_t, Zombie>::INDEX_MASK;
+            tempZombie.xpos = hot.xs[slot];
+            tempZombie.ypos = hot.ys[slot];
+            tempZombie.direction = hot.angles[slot];
+        } else {
+            tempZombie.xpos = zombie.getX();
+            tempZombie.ypos = zombie.getY();
+            tempZombie.direction = zombie.getAngle();
+        }
 
         rtn.push_back(tempZombie);
     }
     return rtn;
 }
 
-std::vector<DeleteAction> getDeletions() {
-    return deleteList;
-}
-
 void deleteEntity(const DeleteAction& da) {
     switch(da.entitytype) {
         case UDPHeaders::MARINE:
@@ -193,15 +179,13 @@ void deleteEntity(const DeleteAction& da) {
     }
 }
 
-void saveDeletion(const DeleteAction& da) {
-    deleteList.push_back(da);
-}
-
 /**
  * Simple wrapper to start the game from a game logic perspective
+ * The match runs in the given world, so several can run at once on their own threads.
  * John Agapeyev March 19
  */
-void startGame() {
+void startGame(GameManager *world) {
+    const GameManager::WorldScope scope(world);
     Game game;
     game.run();
 }
@@ -87,7 +87,7 @@ void fillMulticastAddr(sockaddr_in& addr) {
 void transitionToGameStart() {
     logv("Starting the game\n");
     close(listenSocketTCP);
-    std::thread(startGame).detach();
+    std::thread(startGame, gm).detach();
     //Spinlock
     while (!isGameRunning.load());
     listenUDP(listenSocketUDP, INADDR_ANY, listen_port_udp);
@@ -355,8 +355,10 @@ void processClientUsername(const int sock, const char *buff, std::pair<const int
 
     strncpy(outBuff + TCP_HEADER_SIZE + 1, client.second.entry.username, NAMELEN);
 
+    //the marine is made on the TCP thread, which has to bind the world it joins
+    const GameManager::WorldScope world(gm);
     gm->createMarine(client.first);
-    auto& marine = gm->getMarine(client.first).first;
+    auto& marine = *gm->getMarine(client.first);
     const auto& spawnPoint = base.getSpawnPoint();
     marine.setPosition(spawnPoint.first, spawnPoint.second);
 
@@ -13,7 +13,7 @@
  *            void move(const float playerX, const float playerY,
  *                    const float moveX, const float moveY, CollisionHandler &ch)
  *            void placeTurret()
- *            bool isPlaced() {return placed;}
+ *            bool isPlaced() const {return placed;}
  *            void pickUpTurret()
  *
  * Date: Feb. 02, 2017
@@ -66,9 +66,7 @@ Turret::Turret(const int32_t id, const SDL_Rect& dest, const SDL_Rect& movementS
         const int32_t dropzone): Entity(id, dest, movementSize, projectileSize, damageSize, pickupSize),
         Movable(id, dest, movementSize, projectileSize, damageSize, pickupSize, MARINE_VELOCITY),
         activated(activated), placed(placed), placeable(placeable), range(range) {
-    //movementHitBox.setFriendly(true); Uncomment to allow movement through other players
-    //projectileHitBox.setFriendly(true); Uncomment for no friendly fire
-    //damageHitBox.setFriendly(true); Uncomment for no friendly fire
+    //setPlayerFriendly(true); Uncomment to allow movement through other players and for no friendly fire
     inventory.makeTurretInv();
     logv("Turret created\n");
 }
@@ -153,14 +151,7 @@ bool Turret::collisionCheckTurret(const float playerX, const float playerY, cons
 
     // checks for hitbox overlap if placeable was set to true
     if (placeable) {
-        if (ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getMarineTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getZombieTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getBarricadeTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getWallTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getTurretTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getObjTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getPickUpTree(),this), this)
-            || ch.detectMovementCollision(ch.getQuadTreeEntities(ch.getStoreTree(),this), this)) {
+        if (ch.detectMovementCollision(CollisionCategory::TURRET_BLOCKERS, this)) {
              placeable = false;
          }
     }
@@ -184,10 +175,12 @@ bool Turret::collisionCheckTurret(const float playerX, const float playerY, cons
  * Mar. 31, 2017, Mark Tattrie : Turret now takes damage and dies when health is <= 0.
  */
 void Turret::collidingProjectile(const int damage) {
-    health -= damage;
-    //turret health is less then or equal to 0
-    if(!healthCheckTurret()){
-        GameManager::instance()->deleteTurret(getId());
+    int left;
+#pragma omp atomic capture
+    left = health -= damage;
+    //this hit took the turret's health to 0 or less
+    if (left <= 0 && left + damage > 0) {
+        GameManager::instance()->queueDeletion(UDPHeaders::TURRET, getId());
     }
 }
 
@@ -264,6 +257,7 @@ void Turret::move(const float playerX, const float playerY,
 void Turret::placeTurret() {
     placed = true;
     activated = true;
+    GameManager::instance()->queuePathChange(getId());
 }
 
 /**
@@ -285,6 +279,7 @@ void Turret::placeTurret() {
 void Turret::pickUpTurret() {
     placed = false;
     activated = false;
+    GameManager::instance()->queuePathChange(getId());
 }
 
 /**
@@ -314,7 +309,7 @@ bool Turret::targetScanTurret() {
         //Movement updates
         GameManager *gm = GameManager::instance();
         auto& collision = gm->getCollisionHandler();
-        const auto& zombies = collision.getQuadTreeEntities(collision.getZombieTree(), &visSection);
+        const auto& zombies = collision.getQuadTreeEntities(CollisionCategory::ZOMBIE, &visSection);
 
         //the difference in zombie to target distance
         float movX;
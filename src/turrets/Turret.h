@@ -58,7 +58,7 @@ public:
     void move(const float playerX, const float playerY,
             const float moveX, const float moveY, CollisionHandler& ch);
     void placeTurret();
-    bool isPlaced() {return placed;};
+    bool isPlaced() const {return placed;};
     // Mark Chen, 2017-04-10
     bool isPlaceable() const {return placeable;};
     void pickUpTurret();